@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdio>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief Atomic replacement of files, as shared by the ranking index & checkpoint writers:
+ *        a reader of the path sees either the previous file or the complete new one.
+ */
+namespace AtomicFile {
+/**
+ * @brief Writes all of `size` bytes to a file descriptor, retrying short & interrupted writes.
+ *
+ * @return true if every byte was written, false otherwise
+ */
+inline bool writeAll(const int& fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * @brief Syncs the directory holding a path, so that a rename into it survives a crash.
+ *
+ * @return false if the directory cannot be opened or synced (a file system which
+ *         cannot sync directories at all, ie. EINVAL, counts as success)
+ */
+inline bool syncDirectory(const std::string& path) {
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        return false;
+    }
+    bool synced = ::fsync(fd) == 0 || errno == EINVAL;
+    return ::close(fd) == 0 && synced;
+}
+
+/**
+ * @brief Replaces a file atomically: `write(fd)` fills `<path>.tmp`, which is synced &
+ *        renamed over `path`, then the directory is synced so the rename is durable.
+ *
+ * Never throws of its own accord (so it is safe in a forked child), & never truncates
+ * `path` itself (so a reader mapping the previous file keeps reading it unchanged).
+ *
+ * @param path The path of the file to be (over)written
+ * @param write A callable taking the temporary file's descriptor, returning false on failure
+ * @return false if any step failed, in which case `<path>.tmp` has been removed
+ */
+template <typename Write>
+bool replace(const std::string& path, Write write) {
+    std::string temporary = path + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    bool written = write(fd);
+    written = written && ::fsync(fd) == 0;
+    written = ::close(fd) == 0 && written;
+    if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        ::unlink(temporary.c_str());
+        return false;
+    }
+    return syncDirectory(path);
+}
+};
@@ -0,0 +1,291 @@
+/**
+ * @brief A command-line driver for the measurements behind the ranking structures.
+ *
+ * Build every translation unit of the repository together, eg.
+ *     g++ -std=c++17 -O2 -pthread *.cpp -o benchmark
+ * then run one benchmark by name:
+ *     ./benchmark concurrent [players] [k] [writers] [readers]
+ *     ./benchmark relaxed [players] [k] [threads] [rounds]
+ *     ./benchmark radix [players] [max k]
+ *     ./benchmark histogram [players] [reporting interval] [repeats]
+ *     ./benchmark tiered [players] [k] [hot capacity] [spill path]
+ *     ./benchmark checkpoint [players] [reporting interval] [checkpoint path]
+ *     ./benchmark scored [players] [reporting interval]
+ *
+ * Each benchmark ranks uniformly random Players & prints one line per configuration.
+ */
+#include "Checkpoint.hpp"
+#include "ConcurrentTopK.hpp"
+#include "LinearScore.hpp"
+#include "Parallel.hpp"
+#include "RadixTopK.hpp"
+#include "RelaxedTopK.hpp"
+#include "TieredTopK.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+ * @brief Generates Players with uniformly random levels in [1, max_level] & distinct ids.
+ */
+std::vector<Player> randomPlayers(const size_t& n, const size_t& max_level, const uint64_t& seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<size_t> level(1, max_level);
+    std::vector<Player> players;
+    players.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        players.emplace_back("player" + std::to_string(i), level(rng), i);
+    }
+    return players;
+}
+
+/**
+ * @brief Returns the i-th argument as a number, or `fallback` if it was not given.
+ */
+size_t argument(int argc, char** argv, const int& i, const size_t& fallback) {
+    return i < argc ? std::strtoull(argv[i], nullptr, 10) : fallback;
+}
+
+/**
+ * @brief ConcurrentTopK against a mutex-guarded replaceMin() heap: throughput of offers
+ *        alone at 1, 2, 4 ... writers, then of offers while readers take snapshots.
+ */
+int concurrent(int argc, char** argv) {
+    size_t n = argument(argc, argv, 2, 4000000);
+    size_t k = argument(argc, argv, 3, 1000);
+    unsigned writers = static_cast<unsigned>(argument(argc, argv, 4, Parallel::defaultThreads()));
+    unsigned readers = static_cast<unsigned>(argument(argc, argv, 5, 2));
+    std::vector<Player> players = randomPlayers(n, 1000000000, 1);
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (unsigned threads = 1; threads <= writers; threads *= 2) {
+        RankingResult lockFree = Online::rankConcurrent(players, k, threads, true);
+        RankingResult locked = Online::rankConcurrent(players, k, threads, false);
+        std::cout << "offers  n=" << n << " k=" << k << " writers=" << threads
+                  << "  lock-free " << lockFree.elapsed_ << " ms  mutex " << locked.elapsed_ << " ms\n";
+    }
+
+    Online::ConcurrentStats stats = Online::measureConcurrent(players, k, writers, readers);
+    std::cout << "mixed   n=" << n << " k=" << k << " writers=" << writers << " readers=" << readers
+              << "  lock-free " << stats.lockFreeElapsed_ << " ms (" << stats.lockFreeSnapshots_ << " snapshots, peak "
+              << stats.peakAllocated_ << " nodes)  mutex " << stats.mutexElapsed_ << " ms (" << stats.mutexSnapshots_
+              << " snapshots)\n";
+    return 0;
+}
+
+/**
+ * @brief RelaxedTopK against exact per-thread heaps: throughput at 1, 2, 4 ... threads,
+ *        & the rank error of the relaxed in-flight cutoff.
+ */
+int relaxed(int argc, char** argv) {
+    size_t n = argument(argc, argv, 2, 4000000);
+    size_t k = argument(argc, argv, 3, 1000);
+    unsigned threads = static_cast<unsigned>(argument(argc, argv, 4, Parallel::defaultThreads()));
+    size_t rounds = argument(argc, argv, 5, 16);
+    std::vector<Player> players = randomPlayers(n, 1000000000, 2);
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (unsigned t = 1; t <= threads; t *= 2) {
+        Online::RelaxedStats stats = Online::measureRelaxed(players, k, t, rounds);
+        std::cout << "relaxed n=" << n << " k=" << k << " threads=" << t
+                  << "  relaxed " << stats.relaxedElapsed_ << " ms  sharded " << stats.shardedElapsed_
+                  << " ms  rank error mean " << stats.meanRankError_ << " max " << stats.maxRankError_ << "\n";
+    }
+    return 0;
+}
+
+/**
+ * @brief RadixTopK against the replaceMin() binary heap at k = 1000, 10000 ... up to
+ *        `max k`, over random levels & over rising levels (where every Player is kept).
+ */
+int radix(int argc, char** argv) {
+    size_t n = argument(argc, argv, 2, 4000000);
+    size_t maxK = argument(argc, argv, 3, 1000000);
+    std::vector<Player> random = randomPlayers(n, 1000000000, 3);
+    std::vector<Player> rising = random;
+    std::sort(rising.begin(), rising.end());
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t k = 1000; k <= maxK && k <= n; k *= 10) {
+        for (const auto& [name, players] : { std::make_pair("random", &random), std::make_pair("rising", &rising) }) {
+            Online::RadixStats stats = Online::measureRadix(*players, k);
+            std::cout << "radix   n=" << n << " k=" << k << " " << name << "  heap " << stats.heapElapsed_
+                      << " ms  radix " << stats.radixElapsed_ << " ms" << (stats.matches_ ? "" : "  MISMATCH") << "\n";
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief rankIncoming() with & without the per-interval histogram series, over random
+ *        levels & over rising levels (where every Player is kept).
+ */
+int histogram(int argc, char** argv) {
+    size_t n = argument(argc, argv, 2, 4000000);
+    size_t interval = argument(argc, argv, 3, 1000);
+    size_t repeats = argument(argc, argv, 4, 5);
+    std::vector<Player> random = randomPlayers(n, 1000000000, 4);
+    std::vector<Player> rising = random;
+    std::sort(rising.begin(), rising.end());
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& [name, players] : { std::make_pair("random", &random), std::make_pair("rising", &rising) }) {
+        Online::HistogramStats stats = Online::measureHistograms(*players, interval, repeats);
+        std::cout << "histogram n=" << n << " interval=" << interval << " " << name << "  plain "
+                  << stats.plainElapsed_ << " ms  histograms " << stats.histogramElapsed_ << " ms  overhead "
+                  << stats.overhead_ << "%\n";
+    }
+    return 0;
+}
+
+/**
+ * @brief TieredTopK over random levels at k & 2k: the Players written to runs per Player
+ *        accepted (ie. the write amplification of merging), & the peak spill size.
+ */
+int tiered(int argc, char** argv) {
+    size_t n = argument(argc, argv, 2, 4000000);
+    size_t k = argument(argc, argv, 3, 1000000);
+    size_t hot = argument(argc, argv, 4, 4096);
+    std::string path = argc > 5 ? argv[5] : "tiered.spill";
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (size_t scale = 1; scale <= 2; ++scale) {
+        std::vector<Player> players = randomPlayers(n * scale, 1000000000, 5);
+        Online::TieredTopK board(k * scale, hot, path);
+        size_t accepted = 0;
+        uint64_t peakBytes = 0;
+        size_t peakRuns = 0;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const Player& player : players) {
+            accepted += board.offer(player);
+            peakBytes = std::max(peakBytes, board.spillBytes());
+            peakRuns = std::max(peakRuns, board.runs());
+        }
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        std::cout << "tiered  n=" << n * scale << " k=" << k * scale << " hot=" << hot << "  spilled/accepted "
+                  << static_cast<double>(board.spilled()) / std::max<size_t>(accepted, 1) << "  peak spill "
+                  << peakBytes / 1048576.0 << " MiB in " << peakRuns << " runs  " << elapsed << " ms\n";
+    }
+    return 0;
+}
+
+/**
+ * @brief A checkpoint of a StreamRanker in each mode, taken half-way through the Players
+ *        while the rest are offered: the pause, the parent's copy-on-write faults, & the
+ *        child's peak resident set & own faults.
+ */
+int checkpoint(int argc, char** argv) {
+    size_t n = argument(argc, argv, 2, 4000000);
+    size_t interval = argument(argc, argv, 3, 1000000);
+    std::string path = argc > 4 ? argv[4] : "ranker.checkpoint";
+    std::vector<Player> players = randomPlayers(n, 1000000000, 6);
+
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& [name, mode] : { std::make_pair("fork", Checkpoint::Mode::Fork), std::make_pair("in-process", Checkpoint::Mode::InProcess) }) {
+        Online::StreamRanker ranker(interval);
+        Checkpoint::Checkpointer checkpointer(path);
+        for (size_t i = 0; i < n / 2; ++i) {
+            ranker.offer(players[i]);
+        }
+        checkpointer.start(ranker, mode);
+        for (size_t i = n / 2; i < n; ++i) {
+            ranker.offer(players[i]);
+        }
+        const Checkpoint::Stats& stats = checkpointer.wait();
+
+        std::cout << "checkpoint n=" << n << " interval=" << interval << " " << name << "  pause " << stats.pause_
+                  << " ms  total " << stats.total_ << " ms  " << stats.bytes_ / 1048576.0 << " MiB  parent faults "
+                  << stats.minorFaults_ << "  child peak rss " << stats.childMaxRss_ / 1024.0 << " MiB  child faults "
+                  << stats.childMinorFaults_ << "\n";
+    }
+    return 0;
+}
+
+/**
+ * @brief scoreRank() & rankIncomingScored() over three random attribute columns, against
+ *        scoring every Player into a copy & selecting from it.
+ */
+int scored(int argc, char** argv) {
+    size_t n = argument(argc, argv, 2, 4000000);
+    size_t interval = argument(argc, argv, 3, 1000);
+    std::vector<Player> players = randomPlayers(n, 1000000000, 7);
+
+    //Row i of each column belongs to players[i], whose id_ is also i
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> attribute(0, 1000);
+    std::vector<double> levels(n), wins(n), playtime(n);
+    for (size_t i = 0; i < n; ++i) {
+        levels[i] = static_cast<double>(players[i].level_);
+        wins[i] = attribute(rng);
+        playtime[i] = attribute(rng);
+    }
+    Columns<3> columns { { levels.data(), wins.data(), playtime.data() }, n };
+    LinearScore<3> score { { 1e-6, 2.0, 0.5 }, 0 };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<double> all(n);
+    score.evaluate(columns, size_t { 0 }, n, all.data());
+    std::vector<double> baseline = all;
+    std::nth_element(baseline.begin(), baseline.end() - n / 10, baseline.end());
+    std::sort(baseline.end() - n / 10, baseline.end());
+    double baselineElapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+    ScoredResult offline = Offline::scoreRank(players, columns, score);
+    bool offlineMatches = std::equal(offline.scores_.begin(), offline.scores_.end(), baseline.end() - n / 10, baseline.end());
+
+    VectorPlayerStream stream(players);
+    ScoredResult online = Online::rankIncomingScored(stream, interval, columns, score);
+    std::nth_element(all.begin(), all.end() - std::min(interval, n), all.end());
+    bool onlineMatches = online.scores_.empty() || online.scores_.front() == *(all.end() - std::min(interval, n));
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "scored  n=" << n << " top 10%  copy " << baselineElapsed << " ms  scoreRank " << offline.elapsed_
+              << " ms" << (offlineMatches ? "" : "  MISMATCH") << "\n";
+    std::cout << "scored  n=" << n << " interval=" << interval << "  rankIncomingScored " << online.elapsed_ << " ms"
+              << (onlineMatches ? "" : "  MISMATCH") << "\n";
+    return 0;
+}
+};
+
+int main(int argc, char** argv) {
+    std::string name = argc > 1 ? argv[1] : "";
+    if (name == "concurrent") {
+        return concurrent(argc, argv);
+    }
+    if (name == "relaxed") {
+        return relaxed(argc, argv);
+    }
+    if (name == "radix") {
+        return radix(argc, argv);
+    }
+    if (name == "histogram") {
+        return histogram(argc, argv);
+    }
+    if (name == "tiered") {
+        return tiered(argc, argv);
+    }
+    if (name == "checkpoint") {
+        return checkpoint(argc, argv);
+    }
+    if (name == "scored") {
+        return scored(argc, argv);
+    }
+
+    std::cerr << "Usage: " << argv[0] << " concurrent [players] [k] [writers] [readers]\n"
+              << "       " << argv[0] << " relaxed [players] [k] [threads] [rounds]\n"
+              << "       " << argv[0] << " radix [players] [max k]\n"
+              << "       " << argv[0] << " histogram [players] [reporting interval] [repeats]\n"
+              << "       " << argv[0] << " tiered [players] [k] [hot capacity] [spill path]\n"
+              << "       " << argv[0] << " checkpoint [players] [reporting interval] [checkpoint path]\n"
+              << "       " << argv[0] << " scored [players] [reporting interval]\n";
+    return 1;
+}
@@ -0,0 +1,142 @@
+#include "BucketTopK.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace Online {
+/**
+ * @brief Constructs an empty container holding at most `capacity` Players.
+ *
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param range The (inclusive) range in which every level offered lies
+ */
+BucketTopK::BucketTopK(const size_t& capacity, const LevelRange& range)
+    : range_ { range }
+    , buckets_ { range.hi_ >= range.lo_ ? range.hi_ - range.lo_ + 1 : 0 }
+    , cursor_ { 0 }
+    , capacity_ { capacity }
+    , size_ { 0 }
+{
+}
+
+/**
+ * @brief Offers a Player, which is kept if the container has room or if
+ *        it outranks the current minimum (which is then evicted).
+ *
+ * @param player A reference to the Player to be offered
+ * @return true if the Player was kept, false otherwise
+ * @throws std::out_of_range If the Player's level lies outside the declared range
+ */
+bool BucketTopK::offer(const Player& player) {
+    if (player.level_ < range_.lo_ || player.level_ > range_.hi_) {
+        throw std::out_of_range("Level " + std::to_string(player.level_) + " lies outside the declared range ["
+            + std::to_string(range_.lo_) + ", " + std::to_string(range_.hi_) + "]");
+    }
+    size_t bucket = player.level_ - range_.lo_;
+
+    if (size_ < capacity_) {
+        //While filling, the cursor follows the lowest level seen
+        if (size_ == 0 || bucket < cursor_) {
+            cursor_ = bucket;
+        }
+        buckets_[bucket].push_back(player);
+        size_++;
+        return true;
+    }
+    if (capacity_ == 0 || bucket <= cursor_) {
+        return false;
+    }
+
+    //Evict from the cutoff bucket, then advance the cursor past any emptied buckets
+    buckets_[cursor_].pop_back();
+    buckets_[bucket].push_back(player);
+    while (buckets_[cursor_].empty()) {
+        cursor_++;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the lowest level kept (ie. the cutoff) in O(1).
+ *
+ * @pre The container is non-empty.
+ */
+size_t BucketTopK::cutoff() const {
+    return range_.lo_ + cursor_;
+}
+
+/**
+ * @brief Returns the number of Players currently kept.
+ */
+size_t BucketTopK::size() const {
+    return size_;
+}
+
+/**
+ * @brief Returns whether the container holds `capacity` Players.
+ */
+bool BucketTopK::full() const {
+    return size_ == capacity_;
+}
+
+/**
+ * @brief Copies the Players kept, in sorted (least to greatest) order, by walking
+ *        the buckets from the cursor upwards.
+ */
+std::vector<Player> BucketTopK::sorted() const {
+    std::vector<Player> players;
+    players.reserve(size_);
+    for (size_t i = cursor_; i < buckets_.size() && players.size() < size_; ++i) {
+        players.insert(players.end(), buckets_[i].begin(), buckets_[i].end());
+    }
+    return players;
+}
+
+/**
+ * @brief A version of `rankIncoming()` which keeps the running leaderboard in a
+ *        `BucketTopK` over the declared range of levels.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param range The (inclusive) range in which every level in the stream lies
+ * @return A RankingResult as for `rankIncoming()`
+ * @throws std::out_of_range If a Player's level lies outside the declared range
+ */
+RankingResult rankIncomingBucketed(PlayerStream& stream, const size_t& reporting_interval, const LevelRange& range) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Creates a bucket queue for the top players and a map for cutoffs
+    BucketTopK topPlayers(reporting_interval, range);
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t playerCount = 0;
+
+    //Process the stream until no players remain
+    while (stream.remaining() > 0) {
+        Player currentPlayer = stream.nextPlayer();
+        playerCount++;
+
+        topPlayers.offer(currentPlayer);
+
+        //The cutoff is the cursor, so recording it is a single read
+        if (playerCount % reporting_interval == 0) {
+            cutoffs[playerCount] = topPlayers.cutoff();
+        }
+    }
+
+    // Record cutoff for total players if not already recorded
+    if (topPlayers.size() > 0 && cutoffs.find(playerCount) == cutoffs.end()) {
+        cutoffs[playerCount] = topPlayers.cutoff();
+    }
+
+    //Already bucketed by level, so no sort is needed
+    std::vector<Player> top = topPlayers.sorted();
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //Return the Ranking Result object
+    return RankingResult(top, cutoffs, elapsed);
+}
+};
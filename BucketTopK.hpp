@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <vector>
+
+namespace Online {
+/**
+ * @brief A bounded top-k container of Players whose levels lie in a small, declared
+ *        LevelRange: a bucket queue with one bucket of Players per level.
+ *
+ * A cursor rests on the lowest non-empty bucket (ie. the cutoff level).
+ * - Insertion appends to the bucket of the Player's level in O(1).
+ * - Eviction of the minimum pops from the cursor's bucket in O(1); once the cutoff
+ *   has settled, the cursor only ever moves up, so advancing it over empty buckets
+ *   costs O(range) in total across the whole stream.
+ * - The cutoff is the cursor, & the sorted leaderboard is a walk of the buckets
+ *   from the cursor upwards: no comparisons & no sort.
+ *
+ * @example With a range of [1, 10] & a capacity of 3, offering levels 5, 1, 9, 7
+ * leaves { 5, 7, 9 } with the cursor at 5.
+ */
+class BucketTopK {
+private:
+    LevelRange range_; //The declared (inclusive) range of levels
+    std::vector<std::vector<Player>> buckets_; //Players, by level - range_.lo_
+    size_t cursor_; //The index of the lowest non-empty bucket (meaningless while empty)
+    size_t capacity_; //The maximum number of Players kept
+    size_t size_; //The number of Players currently kept
+
+public:
+    /**
+     * @brief The widest range for which `rankIncoming()` selects a bucket queue:
+     *        beyond this, the (mostly empty) buckets outweigh a heap.
+     */
+    static constexpr size_t MAX_RANGE = size_t(1) << 16;
+
+    /**
+     * @brief Constructs an empty container holding at most `capacity` Players.
+     *
+     * @param capacity The number of Players to keep (ie. the k in top-k)
+     * @param range The (inclusive) range in which every level offered lies
+     */
+    BucketTopK(const size_t& capacity, const LevelRange& range);
+
+    /**
+     * @brief Offers a Player, which is kept if the container has room or if
+     *        it outranks the current minimum (which is then evicted).
+     *
+     * Performs in amortized O(1) time.
+     *
+     * @param player A reference to the Player to be offered
+     * @return true if the Player was kept, false otherwise
+     * @throws std::out_of_range If the Player's level lies outside the declared range
+     */
+    bool offer(const Player& player);
+
+    /**
+     * @brief Returns the lowest level kept (ie. the cutoff) in O(1).
+     *
+     * @pre The container is non-empty.
+     */
+    size_t cutoff() const;
+
+    /**
+     * @brief Returns the number of Players currently kept.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns whether the container holds `capacity` Players.
+     */
+    bool full() const;
+
+    /**
+     * @brief Copies the Players kept, in sorted (least to greatest) order, by walking
+     *        the buckets from the cursor upwards.
+     */
+    std::vector<Player> sorted() const;
+};
+
+/**
+ * @brief A version of `rankIncoming()` which keeps the running leaderboard in a
+ *        `BucketTopK` over the declared range of levels.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param range The (inclusive) range in which every level in the stream lies
+ * @return A RankingResult as for `rankIncoming()`
+ * @throws std::out_of_range If a Player's level lies outside the declared range
+ *
+ * @post All elements of the stream are read until there are none remaining
+ *       (unless an exception is thrown).
+ */
+RankingResult rankIncomingBucketed(PlayerStream& stream, const size_t& reporting_interval, const LevelRange& range);
+};
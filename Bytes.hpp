@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Raw (native byte order) encoding of fixed-size values into byte buffers,
+ *        as used by the ranker state format (whose Players, like those of every
+ *        other format, are encoded by `Snapshot::encode()`).
+ */
+namespace Bytes {
+/**
+ * @brief Appends the raw bytes of a value to a buffer.
+ */
+template <typename T>
+void put(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * @brief Reads the raw bytes of a value from a buffer, advancing the position.
+ *
+ * @param in The buffer to read from
+ * @param pos The position of the value, advanced past it
+ * @param what The name of the format, for the error message (eg. "ranker state")
+ *
+ * @throws std::runtime_error If the buffer ends first.
+ */
+template <typename T>
+T take(const std::string& in, size_t& pos, const char* what) {
+    if (in.size() - pos < sizeof(T)) {
+        throw std::runtime_error(std::string("Truncated ") + what);
+    }
+    T value;
+    std::memcpy(&value, in.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+};
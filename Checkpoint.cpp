@@ -0,0 +1,233 @@
+#include "Checkpoint.hpp"
+#include "AtomicFile.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+/**
+ * @brief Returns the time (ms) on the steady clock.
+ */
+double now() {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Returns the number of minor page faults this process has taken.
+ */
+long minorFaults() {
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+/**
+ * @brief Serializes a ranker straight into `<path>.tmp` (a piece at a time, so no
+ *        second copy of the state is built) & replaces `path` with it atomically.
+ *
+ * @return false if any step failed (in which case `<path>.tmp` has been removed)
+ */
+bool writeFile(const std::string& path, const Online::StreamRanker& ranker) {
+    return AtomicFile::replace(path, [&ranker](const int& fd) {
+        return ranker.serialize([fd](const std::string& piece) {
+            return AtomicFile::writeAll(fd, piece.data(), piece.size());
+        });
+    });
+}
+
+/**
+ * @brief Returns the size of a file (0 if it cannot be read).
+ */
+size_t fileSize(const std::string& path) {
+    struct stat status {};
+    return ::stat(path.c_str(), &status) == 0 ? static_cast<size_t>(status.st_size) : 0;
+}
+};
+
+namespace Checkpoint {
+/**
+ * @brief Constructs a checkpointer writing to a file.
+ *
+ * @param path The path of the checkpoint file
+ */
+Checkpointer::Checkpointer(const std::string& path)
+    : path_ { path }
+    , child_ { -1 }
+    , stats_ { Mode::InProcess, 0, 0, 0, 0, 0, 0, 0 }
+    , startedAt_ { 0 }
+    , faultsAt_ { 0 }
+    , reaped_ { false }
+    , failed_ { false }
+    , exitedAt_ { 0 }
+    , faultsAtExit_ { 0 }
+    , childUsage_ {}
+{
+}
+
+/**
+ * @brief Waits for any checkpoint still in flight.
+ */
+Checkpointer::~Checkpointer() {
+    if (reaper_.joinable()) {
+        reaper_.join();
+    }
+}
+
+/**
+ * @brief Waits for the child in flight to exit (on the reaper thread), then records its
+ *        exit status & resource usage, & the time & the parent's faults at that moment.
+ */
+void Checkpointer::reap() {
+    int status = 0;
+    rusage usage {};
+    pid_t reaped;
+    while ((reaped = ::wait4(child_, &status, 0, &usage)) < 0 && errno == EINTR) {
+    }
+
+    exitedAt_ = now();
+    faultsAtExit_ = minorFaults();
+    failed_ = reaped < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    childUsage_ = usage;
+    reaped_.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Joins the reaper thread of the checkpoint in flight & completes its stats.
+ *
+ * @throws std::runtime_error If the child failed to write the checkpoint.
+ */
+void Checkpointer::collect() {
+    reaper_.join();
+    child_ = -1;
+    if (failed_) {
+        throw std::runtime_error("Checkpoint child failed to write " + path_);
+    }
+    stats_.childMaxRss_ = static_cast<size_t>(childUsage_.ru_maxrss);
+    stats_.childMinorFaults_ = childUsage_.ru_minflt;
+    finish(exitedAt_, faultsAtExit_);
+}
+
+/**
+ * @brief Completes the stats of a checkpoint once its file is complete.
+ *
+ * @param ended_at The time (ms, steady clock) at which the file was complete
+ * @param faults The parent's minor page faults at that time
+ */
+void Checkpointer::finish(const double& ended_at, const long& faults) {
+    stats_.total_ = ended_at - startedAt_;
+    stats_.bytes_ = fileSize(path_);
+    stats_.minorFaults_ = faults - faultsAt_;
+    stats_.extraBytes_ = static_cast<size_t>(stats_.minorFaults_) * static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+/**
+ * @brief Begins a checkpoint of a ranker's current state.
+ *
+ * In Fork mode, returns as soon as the child is running (the file is complete once
+ * `poll()` or `wait()` says so); falls back to InProcess if `fork()` fails.
+ * Should be called from the ingesting thread, while no other thread modifies the ranker.
+ *
+ * @param ranker The ranker to checkpoint
+ * @param mode How to take the checkpoint
+ * @return false if a checkpoint is already in flight (& none was begun), true otherwise
+ *
+ * @throws std::runtime_error If an InProcess checkpoint cannot be written.
+ */
+bool Checkpointer::start(const Online::StreamRanker& ranker, const Mode& mode) {
+    if (poll()) {
+        return false;
+    }
+
+    startedAt_ = now();
+    faultsAt_ = minorFaults();
+
+    if (mode == Mode::Fork) {
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            //The child: serialize the copy-on-write image, & exit without unwinding
+            bool written = false;
+            try {
+                written = writeFile(path_, ranker);
+            } catch (...) {
+            }
+            ::_exit(written ? 0 : 1);
+        }
+        if (pid > 0) {
+            child_ = pid;
+            reaped_.store(false, std::memory_order_relaxed);
+            reaper_ = std::thread(&Checkpointer::reap, this);
+            stats_ = Stats { Mode::Fork, now() - startedAt_, 0, 0, 0, 0, 0, 0 };
+            return true;
+        }
+        //fork() failed (eg. EAGAIN/ENOMEM), so fall back to serializing in process
+    }
+
+    if (!writeFile(path_, ranker)) {
+        throw std::runtime_error("Cannot write checkpoint " + path_);
+    }
+    stats_ = Stats { Mode::InProcess, now() - startedAt_, 0, 0, 0, 0, 0, 0 };
+    finish(now(), minorFaults());
+    return true;
+}
+
+/**
+ * @brief Returns whether a checkpoint is in flight, reaping its child if it has finished.
+ *
+ * @throws std::runtime_error If the child failed to write the checkpoint.
+ */
+bool Checkpointer::poll() {
+    if (child_ < 0) {
+        return false;
+    }
+    if (!reaped_.load(std::memory_order_acquire)) {
+        return true;
+    }
+    collect();
+    return false;
+}
+
+/**
+ * @brief Waits for the checkpoint in flight (if any) to complete.
+ *
+ * @return The measurements of the latest checkpoint
+ * @throws std::runtime_error If the child failed to write the checkpoint.
+ */
+const Stats& Checkpointer::wait() {
+    if (child_ >= 0) {
+        collect();
+    }
+    return stats_;
+}
+
+/**
+ * @brief Returns the measurements of the latest completed checkpoint.
+ */
+const Stats& Checkpointer::stats() const {
+    return stats_;
+}
+
+/**
+ * @brief Reads a checkpoint file back into a ranker.
+ *
+ * @param path The path of the checkpoint file
+ * @return The restored ranker
+ *
+ * @throws std::runtime_error If the file cannot be read or is not a checkpoint.
+ */
+Online::StreamRanker restore(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open checkpoint " + path);
+    }
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return Online::StreamRanker::deserialize(bytes);
+}
+};
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "StreamRanker.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <sys/resource.h>
+#include <sys/types.h>
+
+/**
+ * @brief Checkpointing of an online ranker to a file, without pausing ingestion for
+ *        the serialization.
+ *
+ * In Fork mode, `fork()` gives a child process a copy-on-write image of the ranker; the
+ * child streams its serialization into the file, while the parent returns to ingesting
+ * at once. A reaper thread waits for the child with `wait4()`, so the child's own memory
+ * use & the parent's faults are both measured at the moment the child exits.
+ * The parent only pays for the `fork()` itself (copying page tables), plus a minor page
+ * fault (& a page copy) the first time it writes each page still shared with the child.
+ *
+ * In InProcess mode (& whenever `fork()` fails), the ranker is serialized & written
+ * before returning, so ingestion pauses for the whole checkpoint.
+ *
+ * Either way the file is written to `<path>.tmp` & renamed over `<path>` (see
+ * `AtomicFile::replace()`, which removes the temporary file should any step fail), so
+ * a reader never sees a partial checkpoint; it can be restored with `restore()`.
+ */
+namespace Checkpoint {
+/**
+ * @brief How a checkpoint is taken.
+ */
+enum class Mode {
+    Fork,
+    InProcess
+};
+
+/**
+ * @brief Measurements of one checkpoint.
+ */
+struct Stats {
+    Mode mode_; //The mode actually used (InProcess if fork() failed)
+    double pause_; //Duration (ms) for which the caller was blocked by `start()`
+    double total_; //Duration (ms) from `start()` until the file was complete
+    size_t bytes_; //The size of the checkpoint file
+    long minorFaults_; //The parent's minor page faults from `start()` until the child exited
+    size_t extraBytes_; //The memory copied on write meanwhile (minorFaults_ pages, an upper bound)
+    size_t childMaxRss_; //The child's peak resident set (KiB, counting pages shared with the parent), or 0
+    long childMinorFaults_; //The child's own minor page faults (ie. the memory it allocated), or 0
+};
+
+/**
+ * @brief Takes checkpoints of a StreamRanker to a file, at most one at a time.
+ */
+class Checkpointer {
+private:
+    std::string path_; //The path of the checkpoint file
+    pid_t child_; //The child writing the checkpoint in flight, or -1
+    Stats stats_; //The measurements of the latest checkpoint
+    double startedAt_; //The time (ms, steady clock) at which the checkpoint in flight began
+    long faultsAt_; //The parent's minor page faults when it began
+
+    std::thread reaper_; //Waits for the child in flight to exit
+    std::atomic<bool> reaped_; //Whether the reaper has recorded the child's exit (the fields below)
+    bool failed_; //Whether the child failed to write the checkpoint
+    double exitedAt_; //The time (ms, steady clock) at which the child exited
+    long faultsAtExit_; //The parent's minor page faults at that time
+    rusage childUsage_; //The child's resource usage, as reported by wait4()
+
+    /**
+     * @brief Waits for the child in flight to exit (on the reaper thread), then records its
+     *        exit status & resource usage, & the time & the parent's faults at that moment.
+     */
+    void reap();
+
+    /**
+     * @brief Joins the reaper thread of the checkpoint in flight & completes its stats.
+     *
+     * @throws std::runtime_error If the child failed to write the checkpoint.
+     */
+    void collect();
+
+    /**
+     * @brief Completes the stats of a checkpoint once its file is complete.
+     *
+     * @param ended_at The time (ms, steady clock) at which the file was complete
+     * @param faults The parent's minor page faults at that time
+     */
+    void finish(const double& ended_at, const long& faults);
+
+public:
+    /**
+     * @brief Constructs a checkpointer writing to a file.
+     *
+     * @param path The path of the checkpoint file
+     */
+    Checkpointer(const std::string& path);
+
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    /**
+     * @brief Waits for any checkpoint still in flight.
+     */
+    ~Checkpointer();
+
+    /**
+     * @brief Begins a checkpoint of a ranker's current state.
+     *
+     * In Fork mode, returns as soon as the child is running (the file is complete once
+     * `poll()` or `wait()` says so); falls back to InProcess if `fork()` fails.
+     * Should be called from the ingesting thread, while no other thread modifies the ranker.
+     *
+     * @param ranker The ranker to checkpoint
+     * @param mode How to take the checkpoint
+     * @return false if a checkpoint is already in flight (& none was begun), true otherwise
+     *
+     * @throws std::runtime_error If an InProcess checkpoint cannot be written.
+     */
+    bool start(const Online::StreamRanker& ranker, const Mode& mode = Mode::Fork);
+
+    /**
+     * @brief Returns whether a checkpoint is in flight, reaping its child if it has finished.
+     *
+     * @throws std::runtime_error If the child failed to write the checkpoint.
+     */
+    bool poll();
+
+    /**
+     * @brief Waits for the checkpoint in flight (if any) to complete.
+     *
+     * @return The measurements of the latest checkpoint
+     * @throws std::runtime_error If the child failed to write the checkpoint.
+     */
+    const Stats& wait();
+
+    /**
+     * @brief Returns the measurements of the latest completed checkpoint.
+     */
+    const Stats& stats() const;
+};
+
+/**
+ * @brief Reads a checkpoint file back into a ranker.
+ *
+ * @param path The path of the checkpoint file
+ * @return The restored ranker
+ *
+ * @throws std::runtime_error If the file cannot be read or is not a checkpoint.
+ */
+Online::StreamRanker restore(const std::string& path);
+};
@@ -0,0 +1,621 @@
+#include "ConcurrentTopK.hpp"
+#include "Parallel.hpp"
+
+#include <functional>
+#include <thread>
+
+namespace {
+/**
+ * @brief Strips the deletion mark from a next pointer.
+ */
+template <typename NodeT>
+NodeT* unmarked(const uintptr_t& raw) {
+    return reinterpret_cast<NodeT*>(raw & ~static_cast<uintptr_t>(1));
+}
+
+/**
+ * @brief Returns whether a next pointer carries the deletion mark.
+ */
+bool isMarked(const uintptr_t& raw) {
+    return (raw & 1) != 0;
+}
+
+/**
+ * @brief Draws a skiplist height in [1, maxHeight] with P(h > i) = 2^-i,
+ *        from a per-thread xorshift generator.
+ */
+int randomHeight(const int& maxHeight) {
+    thread_local uint64_t state = 0x9e3779b97f4a7c15ULL ^ reinterpret_cast<uintptr_t>(&state);
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    int height = 1 + __builtin_ctzll(state | (1ULL << (maxHeight - 1)));
+    return std::min(height, maxHeight);
+}
+};
+
+namespace Online {
+/**
+ * @brief Constructs a node of the given height holding a Player.
+ */
+ConcurrentTopK::Node::Node(const Player& player, const uint64_t& seq, const int& height)
+    : player_ { player }
+    , seq_ { seq }
+    , height_ { height }
+    , owners_ { 2 }
+    , retired_ { nullptr }
+{
+    for (int i = 0; i < MAX_HEIGHT; ++i) {
+        next_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Claims a free epoch slot (starting from one picked by the thread's id) &
+ *        announces the global epoch in it.
+ */
+ConcurrentTopK::Guard::Guard(ConcurrentTopK& board) {
+    thread_local size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+    for (size_t i = hint;; ++i) {
+        Slot& slot = board.slots_[i % SLOTS];
+        bool expected = false;
+        if (!slot.claimed_.load(std::memory_order_relaxed) && slot.claimed_.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            slot_ = &slot;
+            hint = i;
+            break;
+        }
+    }
+
+    //Re-announce until the epoch is stable, so that no advance can have missed it
+    uint64_t epoch;
+    do {
+        epoch = board.epoch_.load();
+        slot_->epoch_.store(epoch);
+    } while (board.epoch_.load() != epoch);
+}
+
+/**
+ * @brief Withdraws the announcement & frees the slot.
+ */
+ConcurrentTopK::Guard::~Guard() {
+    slot_->epoch_.store(IDLE, std::memory_order_release);
+    slot_->claimed_.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Constructs an empty board holding at most `capacity` Players.
+ *
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ */
+ConcurrentTopK::ConcurrentTopK(const size_t& capacity)
+    : head_ { Player(), 0, MAX_HEIGHT }
+    , capacity_ { capacity }
+    , size_ { 0 }
+    , minLevel_ { 0 }
+    , seq_ { 1 }
+    , slots_ { new Slot[SLOTS] }
+    , epoch_ { 0 }
+    , limbo_ { { nullptr }, { nullptr }, { nullptr } }
+    , retirements_ { 0 }
+    , nodes_ { 0 }
+    , begun_ { 0 }
+    , ended_ { 0 }
+    , snapshotting_ { 0 }
+{
+}
+
+/**
+ * @brief Frees every node still on the board or awaiting reclamation.
+ */
+ConcurrentTopK::~ConcurrentTopK() {
+    for (std::atomic<Node*>& limbo : limbo_) {
+        free(limbo.exchange(nullptr));
+    }
+
+    //Every evicted node has been retired, so only the live ones remain
+    Node* node = unmarked<Node>(head_.next_[0].load());
+    while (node != nullptr) {
+        uintptr_t next = node->next_[0].load();
+        if (!isMarked(next)) {
+            delete node;
+        }
+        node = unmarked<Node>(next);
+    }
+}
+
+/**
+ * @brief Returns whether node `a` orders before the key (level, id, seq).
+ */
+bool ConcurrentTopK::before(const Node* a, const size_t& level, const size_t& id, const uint64_t& seq) {
+    if (a->player_.level_ != level) {
+        return a->player_.level_ < level;
+    }
+    if (a->player_.id_ != id) {
+        return a->player_.id_ < id;
+    }
+    return a->seq_ < seq;
+}
+
+/**
+ * @brief Fills preds/succs with the nodes on either side of the key at every level,
+ *        unlinking any deleted nodes met along the way.
+ */
+void ConcurrentTopK::find(const size_t& level, const size_t& id, const uint64_t& seq, Node** preds, Node** succs) {
+retry:
+    Node* pred = &head_;
+    for (int i = MAX_HEIGHT - 1; i >= 0; --i) {
+        Node* curr = unmarked<Node>(pred->next_[i].load(std::memory_order_acquire));
+
+        while (curr != nullptr) {
+            uintptr_t succ = curr->next_[i].load(std::memory_order_acquire);
+
+            //Snip out nodes deleted at this level; start over if pred changed under us
+            while (isMarked(succ)) {
+                uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+                if (!pred->next_[i].compare_exchange_strong(expected, succ & ~static_cast<uintptr_t>(1), std::memory_order_acq_rel)) {
+                    goto retry;
+                }
+                curr = unmarked<Node>(succ);
+                if (curr == nullptr) {
+                    break;
+                }
+                succ = curr->next_[i].load(std::memory_order_acquire);
+            }
+
+            if (curr != nullptr && before(curr, level, id, seq)) {
+                pred = curr;
+                curr = unmarked<Node>(succ);
+            } else {
+                break;
+            }
+        }
+
+        preds[i] = pred;
+        succs[i] = curr;
+    }
+}
+
+/**
+ * @brief Links a new node holding `player` into every level of its height.
+ */
+void ConcurrentTopK::insert(const Player& player) {
+    Node* preds[MAX_HEIGHT];
+    Node* succs[MAX_HEIGHT];
+    uint64_t seq = seq_.fetch_add(1, std::memory_order_relaxed);
+    Node* node = new Node(player, seq, randomHeight(MAX_HEIGHT));
+    nodes_.fetch_add(1, std::memory_order_relaxed);
+
+    //Link the bottom level, which is the linearization point of the insert
+    while (true) {
+        find(player.level_, player.id_, seq, preds, succs);
+        for (int i = 0; i < node->height_; ++i) {
+            node->next_[i].store(reinterpret_cast<uintptr_t>(succs[i]), std::memory_order_relaxed);
+        }
+
+        uintptr_t expected = reinterpret_cast<uintptr_t>(succs[0]);
+        beginWrite();
+        bool linked = preds[0]->next_[0].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node), std::memory_order_acq_rel);
+        endWrite();
+        if (linked) {
+            break;
+        }
+    }
+
+    //Link the upper levels, giving up should the node be evicted in the meantime
+    for (int i = 1; i < node->height_; ++i) {
+        bool evicted = false;
+        while (!evicted) {
+            uintptr_t expected = reinterpret_cast<uintptr_t>(succs[i]);
+            if (preds[i]->next_[i].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node), std::memory_order_acq_rel)) {
+                break;
+            }
+
+            find(player.level_, player.id_, seq, preds, succs);
+            uintptr_t current = node->next_[i].load(std::memory_order_acquire);
+            evicted = isMarked(current) || isMarked(node->next_[0].load(std::memory_order_acquire))
+                || !node->next_[i].compare_exchange_strong(current, reinterpret_cast<uintptr_t>(succs[i]), std::memory_order_acq_rel);
+        }
+        if (evicted) {
+            break;
+        }
+    }
+
+    //Had the node been evicted while we linked it, our links may postdate the evictor's
+    //unlinking, so unlink it again before letting it be retired
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (isMarked(node->next_[0].load(std::memory_order_acquire))) {
+        find(player.level_, player.id_, seq, preds, succs);
+    }
+    release(node);
+}
+
+/**
+ * @brief Evicts the first live node of the bottom level.
+ *
+ * @return true if a node was evicted, false if the list was empty
+ */
+bool ConcurrentTopK::popMin() {
+    Node* preds[MAX_HEIGHT];
+    Node* succs[MAX_HEIGHT];
+    Node* curr = unmarked<Node>(head_.next_[0].load(std::memory_order_acquire));
+
+    while (curr != nullptr) {
+        uintptr_t succ = curr->next_[0].load(std::memory_order_acquire);
+        if (isMarked(succ)) {
+            curr = unmarked<Node>(succ);
+            continue;
+        }
+
+        //Mark the upper levels top-down, so no new links are made through them
+        for (int i = curr->height_ - 1; i >= 1; --i) {
+            uintptr_t next = curr->next_[i].load(std::memory_order_acquire);
+            while (!isMarked(next) && !curr->next_[i].compare_exchange_weak(next, next | 1, std::memory_order_acq_rel)) {
+            }
+        }
+
+        //Whoever marks the bottom level owns the eviction, & unlinks the node at every level
+        while (!isMarked(succ)) {
+            beginWrite();
+            bool marked = curr->next_[0].compare_exchange_strong(succ, succ | 1, std::memory_order_acq_rel);
+            endWrite();
+            if (marked) {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                find(curr->player_.level_, curr->player_.id_, curr->seq_, preds, succs);
+                release(curr);
+                return true;
+            }
+        }
+        curr = unmarked<Node>(succ);
+    }
+    return false;
+}
+
+/**
+ * @brief Publishes the level of the first live node as the minimum.
+ */
+void ConcurrentTopK::publishMin() {
+    Node* curr = unmarked<Node>(head_.next_[0].load(std::memory_order_acquire));
+    while (curr != nullptr) {
+        uintptr_t succ = curr->next_[0].load(std::memory_order_acquire);
+        if (!isMarked(succ)) {
+            minLevel_.store(curr->player_.level_, std::memory_order_release);
+            return;
+        }
+        curr = unmarked<Node>(succ);
+    }
+}
+
+/**
+ * @brief Marks the start of a change to the bottom level, waiting while a snapshot
+ *        holds offers back.
+ */
+void ConcurrentTopK::beginWrite() {
+    while (true) {
+        begun_.fetch_add(1);
+        if (snapshotting_.load() == 0) {
+            return;
+        }
+
+        //Step aside (as if this change had ended) until the snapshot is taken
+        ended_.fetch_add(1);
+        while (snapshotting_.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/**
+ * @brief Marks the end of a change to the bottom level.
+ */
+void ConcurrentTopK::endWrite() {
+    ended_.fetch_add(1);
+}
+
+/**
+ * @brief Drops the inserter's or evictor's claim on an unlinked node, retiring it
+ *        if that was the last.
+ */
+void ConcurrentTopK::release(Node* node) {
+    if (node->owners_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        retire(node);
+    }
+}
+
+/**
+ * @brief Adds an unreachable node to the limbo list of the current epoch.
+ */
+void ConcurrentTopK::retire(Node* node) {
+    std::atomic<Node*>& limbo = limbo_[epoch_.load() % 3];
+    Node* top = limbo.load(std::memory_order_relaxed);
+    do {
+        node->retired_ = top;
+    } while (!limbo.compare_exchange_weak(top, node, std::memory_order_release, std::memory_order_relaxed));
+
+    if ((retirements_.fetch_add(1, std::memory_order_relaxed) + 1) % ADVANCE_EVERY == 0) {
+        tryAdvance();
+    }
+}
+
+/**
+ * @brief Advances the global epoch if every active slot has announced it,
+ *        freeing the nodes retired two epochs before.
+ */
+void ConcurrentTopK::tryAdvance() {
+    uint64_t epoch = epoch_.load();
+    for (size_t i = 0; i < SLOTS; ++i) {
+        uint64_t announced = slots_[i].epoch_.load();
+        if (announced != IDLE && announced != epoch) {
+            return;
+        }
+    }
+    if (!epoch_.compare_exchange_strong(epoch, epoch + 1)) {
+        return;
+    }
+
+    //Every operation which could hold a node retired in epoch - 1 has since ended
+    free(limbo_[(epoch + 2) % 3].exchange(nullptr, std::memory_order_acquire));
+}
+
+/**
+ * @brief Frees a limbo list.
+ */
+void ConcurrentTopK::free(Node* node) {
+    while (node != nullptr) {
+        Node* next = node->retired_;
+        delete node;
+        nodes_.fetch_sub(1, std::memory_order_relaxed);
+        node = next;
+    }
+}
+
+/**
+ * @brief Offers a Player; safe to call from any number of threads at once.
+ *
+ * @param player A reference to the Player to be offered
+ * @return true if the Player was linked into the board, false if it was rejected
+ *         at the published cutoff
+ */
+bool ConcurrentTopK::offer(const Player& player) {
+    if (capacity_ == 0) {
+        return false;
+    }
+
+    //Below-cutoff Players cost a single pair of atomic loads
+    if (size_.load(std::memory_order_acquire) >= capacity_ && player.level_ <= minLevel_.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    Guard guard(*this);
+    insert(player);
+
+    //Every insert beyond the capacity pays for exactly one eviction
+    if (size_.fetch_add(1, std::memory_order_acq_rel) + 1 > capacity_) {
+        popMin();
+        size_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+    if (size_.load(std::memory_order_acquire) >= capacity_) {
+        publishMin();
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the published minimum level (ie. the cutoff) once full, or 0.
+ */
+size_t ConcurrentTopK::cutoff() const {
+    return minLevel_.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Walks the bottom level, appending the live Players to `players`.
+ */
+void ConcurrentTopK::walk(std::vector<Player>& players) const {
+    const Node* curr = unmarked<const Node>(head_.next_[0].load(std::memory_order_acquire));
+    while (curr != nullptr) {
+        uintptr_t succ = curr->next_[0].load(std::memory_order_acquire);
+        if (!isMarked(succ)) {
+            players.push_back(curr->player_);
+        }
+        curr = unmarked<const Node>(succ);
+    }
+}
+
+/**
+ * @brief Returns the Players on the board at a single point in time, in sorted (least
+ *        to greatest) order; safe to call from any number of threads at once.
+ *
+ * Should evictions be pending at that point (ie. Players linked beyond the capacity),
+ * only the top <capacity> Players are returned, as they are the ones to be kept.
+ */
+std::vector<Player> ConcurrentTopK::snapshot() {
+    Guard guard(*this);
+    std::vector<Player> players;
+    players.reserve(std::min(capacity_, size_.load(std::memory_order_acquire)));
+
+    //A walk is valid if no change was in flight before it, & none began during it
+    auto attempt = [&]() {
+        uint64_t begun = begun_.load();
+        if (ended_.load() != begun) {
+            return false;
+        }
+        players.clear();
+        walk(players);
+        return begun_.load() == begun;
+    };
+
+    bool taken = false;
+    for (int i = 0; i < SNAPSHOT_ATTEMPTS && !taken; ++i) {
+        taken = attempt();
+    }
+    if (!taken) {
+        //Hold new changes back until a walk succeeds
+        snapshotting_.fetch_add(1);
+        while (!attempt()) {
+            std::this_thread::yield();
+        }
+        snapshotting_.fetch_sub(1);
+    }
+
+    if (players.size() > capacity_) {
+        players.erase(players.begin(), players.end() - capacity_);
+    }
+    return players;
+}
+
+/**
+ * @brief Returns the number of nodes allocated & not yet freed (those on the board,
+ *        plus those evicted but awaiting reclamation).
+ */
+size_t ConcurrentTopK::allocated() const {
+    return nodes_.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Constructs an empty board holding at most `capacity` Players.
+ */
+MutexTopK::MutexTopK(const size_t& capacity)
+    : capacity_ { capacity }
+{
+    heap_.reserve(capacity);
+}
+
+/**
+ * @brief Offers a Player; safe to call from any number of threads at once.
+ *
+ * @return true if the Player was kept, false otherwise
+ */
+bool MutexTopK::offer(const Player& player) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (heap_.size() < capacity_) {
+        heap_.push_back(player);
+        if (heap_.size() == capacity_) {
+            std::make_heap(heap_.begin(), heap_.end(), std::greater<Player>());
+        }
+        return true;
+    }
+    if (capacity_ == 0 || !(player > heap_.front())) {
+        return false;
+    }
+
+    Player target = player;
+    replaceMin(heap_.begin(), heap_.end(), target);
+    return true;
+}
+
+/**
+ * @brief Returns the Players on the board in sorted (least to greatest) order.
+ */
+std::vector<Player> MutexTopK::snapshot() const {
+    std::vector<Player> players;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        players = heap_;
+    }
+    std::sort(players.begin(), players.end());
+    return players;
+}
+
+/**
+ * @brief Ranks a collection of Players by offering equal slices of it from several
+ *        threads at once into a shared concurrent top-k.
+ *
+ * @param players The Players to be ranked
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param threads The number of threads offering Players
+ * @param lock_free Whether to use a `ConcurrentTopK` (true) or a `MutexTopK` (false)
+ * @return A RankingResult in which:
+ * - top_       -> Contains the top <capacity> Players in sorted (least to greatest) order
+ * - cutoffs_   -> Is empty
+ * - elapsed_   -> Contains the duration (ms) of the concurrent offers & the final snapshot
+ */
+RankingResult rankConcurrent(const std::vector<Player>& players, const size_t& capacity, const unsigned& threads, const bool& lock_free) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<Player> topPlayers;
+    if (lock_free) {
+        ConcurrentTopK board(capacity);
+        Parallel::forChunks(players.size(), threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                board.offer(players[i]);
+            }
+        });
+        topPlayers = board.snapshot();
+    } else {
+        MutexTopK board(capacity);
+        Parallel::forChunks(players.size(), threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                board.offer(players[i]);
+            }
+        });
+        topPlayers = board.snapshot();
+    }
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return RankingResult(topPlayers, {}, elapsed);
+}
+
+/**
+ * @brief Measures `ConcurrentTopK` against `MutexTopK` when many threads both update &
+ *        read: `writers` threads offer equal slices of the Players while `readers`
+ *        threads take snapshots until the offers are done.
+ *
+ * @param players The Players to be offered
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param writers The number of threads offering Players
+ * @param readers The number of threads taking snapshots
+ * @return The measured ConcurrentStats
+ */
+ConcurrentStats measureConcurrent(const std::vector<Player>& players, const size_t& capacity, const unsigned& writers, const unsigned& readers) {
+    ConcurrentStats stats { 0, 0, 0, 0, 0 };
+    ConcurrentTopK lockFree(capacity);
+    MutexTopK locked(capacity);
+
+    //Offers every Player into a board while readers snapshot it, returning the elapsed ms
+    auto run = [&](auto& board, size_t& snapshots, auto sample) {
+        std::atomic<bool> done { false };
+        std::atomic<size_t> taken { 0 };
+        std::vector<std::thread> readerThreads;
+        for (unsigned r = 0; r < readers; ++r) {
+            readerThreads.emplace_back([&]() {
+                while (!done.load(std::memory_order_acquire)) {
+                    board.snapshot();
+                    taken.fetch_add(1, std::memory_order_relaxed);
+                    sample();
+                }
+            });
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        Parallel::forChunks(players.size(), writers, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                board.offer(players[i]);
+            }
+        });
+        auto end = std::chrono::high_resolution_clock::now();
+
+        done.store(true, std::memory_order_release);
+        for (std::thread& reader : readerThreads) {
+            reader.join();
+        }
+        snapshots = taken.load();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    };
+
+    std::atomic<size_t> peak { 0 };
+    stats.lockFreeElapsed_ = run(lockFree, stats.lockFreeSnapshots_, [&]() {
+        size_t allocated = lockFree.allocated();
+        size_t seen = peak.load(std::memory_order_relaxed);
+        while (allocated > seen && !peak.compare_exchange_weak(seen, allocated)) {
+        }
+    });
+    stats.mutexElapsed_ = run(locked, stats.mutexSnapshots_, []() {});
+    stats.peakAllocated_ = std::max(peak.load(), lockFree.allocated());
+    return stats;
+}
+};
@@ -0,0 +1,271 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Online {
+/**
+ * @brief A bounded top-k of Players which many threads may offer to (& read from)
+ *        at once: a lock-free skiplist ordered by (level, id).
+ *
+ * - `offer()` first compares against the atomically published minimum level, so
+ *   below-cutoff Players (the vast majority, once full) return after one atomic load.
+ * - A Player above it is linked into the skiplist with CAS operations; once the
+ *   size exceeds the capacity, the thread evicts the first node of the bottom level
+ *   (by marking its next pointers, then unlinking it) & republishes the minimum.
+ * - `snapshot()` is linearizable: it walks the bottom level (so it is always in
+ *   ascending order) between two reads of a pair of write counters, & only accepts
+ *   a walk during which no insert or eviction took effect. Should offers keep
+ *   invalidating its walks, it briefly holds new offers back until a walk succeeds.
+ *
+ * Evicted nodes are freed by epoch-based reclamation: each operation announces the
+ * global epoch in a slot while it may hold node pointers, & a node is retired (to the
+ * limbo list of the epoch in which it became unreachable) once both its evictor & its
+ * inserter are done with it. The epoch advances once every active slot has announced
+ * it, & a limbo list is freed two epochs on, when no operation can still hold its nodes.
+ *
+ * @example With 8 threads each offering a slice of a stream, then snapshot()
+ * returns the same levels as `rankIncoming()` over the whole stream.
+ */
+class ConcurrentTopK {
+private:
+    static constexpr int MAX_HEIGHT = 24; //Enough levels for ~16M Players at p = 1/2
+    static constexpr size_t SLOTS = 128; //The number of epoch slots (ie. of operations at once)
+    static constexpr uint64_t IDLE = ~0ULL; //The epoch of a slot with no operation in it
+    static constexpr size_t ADVANCE_EVERY = 64; //The number of retirements per attempt to advance the epoch
+    static constexpr int SNAPSHOT_ATTEMPTS = 64; //The number of optimistic walks before holding offers back
+
+    /**
+     * @brief A skiplist node. The lowest bit of each next_ pointer marks the node
+     *        itself as (logically) deleted at that level.
+     */
+    struct Node {
+        Player player_;
+        uint64_t seq_; //A unique ticket, so that equal (level, id) pairs remain distinct keys
+        int height_;
+        std::atomic<uintptr_t> next_[MAX_HEIGHT];
+        std::atomic<int> owners_; //The inserter & evictor still using the node (retired at 0)
+        Node* retired_; //The next node of its limbo list
+
+        Node(const Player& player, const uint64_t& seq, const int& height);
+    };
+
+    /**
+     * @brief The epoch announced by one operation in progress, padded to its own cache line.
+     */
+    struct alignas(64) Slot {
+        std::atomic<bool> claimed_ { false }; //Whether an operation holds the slot
+        std::atomic<uint64_t> epoch_ { IDLE }; //The epoch it announced, or IDLE
+    };
+
+    /**
+     * @brief Holds an epoch slot for the duration of an operation.
+     */
+    class Guard {
+    private:
+        Slot* slot_; //The slot held
+
+    public:
+        Guard(ConcurrentTopK& board);
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard();
+    };
+
+    Node head_; //A sentinel ordered before every Player
+    size_t capacity_; //The number of Players to keep (ie. the k in top-k)
+    std::atomic<size_t> size_; //The number of Players linked & not yet evicted (roughly, in flight)
+    std::atomic<size_t> minLevel_; //The published minimum level (ie. the cutoff) once full
+    std::atomic<uint64_t> seq_; //The next ticket to hand out
+
+    std::unique_ptr<Slot[]> slots_; //The epoch slots
+    std::atomic<uint64_t> epoch_; //The global epoch
+    std::atomic<Node*> limbo_[3]; //The nodes retired in each epoch (modulo 3), not yet freed
+    std::atomic<size_t> retirements_; //The number of nodes retired so far
+    std::atomic<size_t> nodes_; //The number of nodes allocated & not yet freed
+
+    std::atomic<uint64_t> begun_; //The number of inserts/evictions begun (ie. about to take effect)
+    std::atomic<uint64_t> ended_; //The number of inserts/evictions ended (ie. taken effect, or not)
+    std::atomic<size_t> snapshotting_; //The number of snapshots holding offers back
+
+    /**
+     * @brief Returns whether node `a` orders before the key (level, id, seq).
+     */
+    static bool before(const Node* a, const size_t& level, const size_t& id, const uint64_t& seq);
+
+    /**
+     * @brief Fills preds/succs with the nodes on either side of the key at every level,
+     *        unlinking any deleted nodes met along the way.
+     */
+    void find(const size_t& level, const size_t& id, const uint64_t& seq, Node** preds, Node** succs);
+
+    /**
+     * @brief Links a new node holding `player` into every level of its height.
+     */
+    void insert(const Player& player);
+
+    /**
+     * @brief Evicts the first live node of the bottom level.
+     *
+     * @return true if a node was evicted, false if the list was empty
+     */
+    bool popMin();
+
+    /**
+     * @brief Publishes the level of the first live node as the minimum.
+     */
+    void publishMin();
+
+    /**
+     * @brief Marks the start of a change to the bottom level, waiting while a snapshot
+     *        holds offers back.
+     */
+    void beginWrite();
+
+    /**
+     * @brief Marks the end of a change to the bottom level.
+     */
+    void endWrite();
+
+    /**
+     * @brief Drops the inserter's or evictor's claim on an unlinked node, retiring it
+     *        if that was the last.
+     */
+    void release(Node* node);
+
+    /**
+     * @brief Adds an unreachable node to the limbo list of the current epoch.
+     */
+    void retire(Node* node);
+
+    /**
+     * @brief Advances the global epoch if every active slot has announced it,
+     *        freeing the nodes retired two epochs before.
+     */
+    void tryAdvance();
+
+    /**
+     * @brief Frees a limbo list.
+     */
+    void free(Node* node);
+
+    /**
+     * @brief Walks the bottom level, appending the live Players to `players`.
+     */
+    void walk(std::vector<Player>& players) const;
+
+public:
+    /**
+     * @brief Constructs an empty board holding at most `capacity` Players.
+     *
+     * @param capacity The number of Players to keep (ie. the k in top-k)
+     */
+    ConcurrentTopK(const size_t& capacity);
+    ConcurrentTopK(const ConcurrentTopK&) = delete;
+    ConcurrentTopK& operator=(const ConcurrentTopK&) = delete;
+    ~ConcurrentTopK();
+
+    /**
+     * @brief Offers a Player; safe to call from any number of threads at once.
+     *
+     * @param player A reference to the Player to be offered
+     * @return true if the Player was linked into the board, false if it was rejected
+     *         at the published cutoff
+     */
+    bool offer(const Player& player);
+
+    /**
+     * @brief Returns the published minimum level (ie. the cutoff) once full, or 0.
+     */
+    size_t cutoff() const;
+
+    /**
+     * @brief Returns the Players on the board at a single point in time, in sorted (least
+     *        to greatest) order; safe to call from any number of threads at once.
+     *
+     * Should evictions be pending at that point (ie. Players linked beyond the capacity),
+     * only the top <capacity> Players are returned, as they are the ones to be kept.
+     */
+    std::vector<Player> snapshot();
+
+    /**
+     * @brief Returns the number of nodes allocated & not yet freed (those on the board,
+     *        plus those evicted but awaiting reclamation).
+     */
+    size_t allocated() const;
+};
+
+/**
+ * @brief The baseline a concurrent top-k is compared against: the heap of
+ *        `rankIncoming()` & `replaceMin()`, guarded by a single mutex.
+ */
+class MutexTopK {
+private:
+    mutable std::mutex mutex_; //Guards every member below
+    std::vector<Player> heap_; //Min-heap by level, once full
+    size_t capacity_; //The number of Players to keep (ie. the k in top-k)
+
+public:
+    /**
+     * @brief Constructs an empty board holding at most `capacity` Players.
+     */
+    MutexTopK(const size_t& capacity);
+
+    /**
+     * @brief Offers a Player; safe to call from any number of threads at once.
+     *
+     * @return true if the Player was kept, false otherwise
+     */
+    bool offer(const Player& player);
+
+    /**
+     * @brief Returns the Players on the board in sorted (least to greatest) order.
+     */
+    std::vector<Player> snapshot() const;
+};
+
+/**
+ * @brief Ranks a collection of Players by offering equal slices of it from several
+ *        threads at once into a shared concurrent top-k, as a benchmark of
+ *        `ConcurrentTopK` against `MutexTopK`.
+ *
+ * @param players The Players to be ranked
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param threads The number of threads offering Players
+ * @param lock_free Whether to use a `ConcurrentTopK` (true) or a `MutexTopK` (false)
+ * @return A RankingResult in which:
+ * - top_       -> Contains the top <capacity> Players in sorted (least to greatest) order
+ * - cutoffs_   -> Is empty
+ * - elapsed_   -> Contains the duration (ms) of the concurrent offers & the final snapshot
+ */
+RankingResult rankConcurrent(const std::vector<Player>& players, const size_t& capacity, const unsigned& threads, const bool& lock_free = true);
+
+/**
+ * @brief Measurements of a concurrent top-k under mixed offers & snapshots.
+ */
+struct ConcurrentStats {
+    double lockFreeElapsed_; //Duration (ms) of the offers into a ConcurrentTopK
+    double mutexElapsed_; //Duration (ms) of the offers into a MutexTopK
+    size_t lockFreeSnapshots_; //The number of snapshots taken of the ConcurrentTopK meanwhile
+    size_t mutexSnapshots_; //The number of snapshots taken of the MutexTopK meanwhile
+    size_t peakAllocated_; //The most nodes the ConcurrentTopK held at once (see `allocated()`)
+};
+
+/**
+ * @brief Measures `ConcurrentTopK` against `MutexTopK` when many threads both update &
+ *        read: `writers` threads offer equal slices of the Players while `readers`
+ *        threads take snapshots until the offers are done.
+ *
+ * @param players The Players to be offered
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param writers The number of threads offering Players
+ * @param readers The number of threads taking snapshots
+ * @return The measured ConcurrentStats
+ */
+ConcurrentStats measureConcurrent(const std::vector<Player>& players, const size_t& capacity, const unsigned& writers, const unsigned& readers);
+};
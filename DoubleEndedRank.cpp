@@ -0,0 +1,234 @@
+#include "DoubleEndedRank.hpp"
+
+namespace {
+const ptrdiff_t SMALL_RANGE = 16; //Ranges this small are simply sorted
+
+/**
+ * @brief Rearranges players[lo, hi) such that every target index in [tFirst, tLast)
+ *        holds the Player it would hold were the range sorted, with no greater
+ *        Player before it & no smaller Player after it.
+ *
+ * @pre The target indices are sorted & lie within [lo, hi).
+ */
+void dualSelect(std::vector<Player>& v, ptrdiff_t lo, ptrdiff_t hi,
+    const size_t* tFirst, const size_t* tLast) {
+    while (tFirst != tLast) {
+        if (hi - lo <= SMALL_RANGE) {
+            std::sort(v.begin() + lo, v.begin() + hi);
+            return;
+        }
+
+        //Use the tertiles as pivots, moved to either end of the range
+        ptrdiff_t n = hi - lo;
+        std::swap(v[lo], v[lo + n / 3]);
+        std::swap(v[hi - 1], v[lo + 2 * n / 3]);
+        if (v[hi - 1] < v[lo]) {
+            std::swap(v[lo], v[hi - 1]);
+        }
+        size_t p1 = v[lo].level_;
+        size_t p2 = v[hi - 1].level_;
+
+        //Yaroslavskiy partition: [lo, l) < p1 <= [l, g] <= p2 < (g, hi)
+        ptrdiff_t l = lo + 1;
+        ptrdiff_t g = hi - 2;
+        for (ptrdiff_t k = l; k <= g; ++k) {
+            if (v[k].level_ < p1) {
+                std::swap(v[k], v[l++]);
+            } else if (v[k].level_ > p2) {
+                while (v[g].level_ > p2 && k < g) {
+                    --g;
+                }
+                std::swap(v[k], v[g--]);
+                if (v[k].level_ < p1) {
+                    std::swap(v[k], v[l++]);
+                }
+            }
+        }
+        --l;
+        ++g;
+        std::swap(v[lo], v[l]);
+        std::swap(v[hi - 1], v[g]);
+
+        //Split the targets between the three segments (targets at a pivot are done)
+        const size_t* leftEnd = std::lower_bound(tFirst, tLast, static_cast<size_t>(l));
+        const size_t* midBegin = std::upper_bound(leftEnd, tLast, static_cast<size_t>(l));
+        const size_t* midEnd = std::lower_bound(midBegin, tLast, static_cast<size_t>(g));
+        const size_t* rightBegin = std::upper_bound(midEnd, tLast, static_cast<size_t>(g));
+
+        //A middle segment between equal pivots is all one level, so already in place
+        bool midDone = p1 == p2;
+
+        if (leftEnd != tFirst) {
+            dualSelect(v, lo, l, tFirst, leftEnd);
+        }
+        if (!midDone && midEnd != midBegin) {
+            dualSelect(v, l + 1, g, midBegin, midEnd);
+        }
+
+        //Loop (rather than recurse) on the right segment
+        lo = g + 1;
+        tFirst = rightBegin;
+    }
+}
+
+/**
+ * @brief Replaces the root of a heap ordered by `comp` & percolates it down,
+ *        as `replaceMin()` does for a min-heap.
+ */
+template <typename Compare>
+void replaceRoot(Online::PlayerIt first, Online::PlayerIt last, Player& target, Compare comp) {
+    if (first == last) {
+        return;
+    }
+
+    *first = std::move(target);
+    size_t heapSize = std::distance(first, last);
+    size_t current = 0;
+
+    while (true) {
+        size_t leftChildIdx = 2 * current + 1;
+        size_t rightChildIdx = 2 * current + 2;
+        size_t best = current;
+
+        if (leftChildIdx < heapSize && comp(first[best], first[leftChildIdx])) {
+            best = leftChildIdx;
+        }
+        if (rightChildIdx < heapSize && comp(first[best], first[rightChildIdx])) {
+            best = rightChildIdx;
+        }
+
+        if (best == current) {
+            break;
+        }
+
+        std::swap(first[current], first[best]);
+        current = best;
+    }
+}
+};
+
+namespace Offline {
+/**
+ * @brief Uses a dual-pivot quickselect to select both the top 10% & the bottom 10%
+ *        of players in a single partitioning pass, then sorts each end.
+ *
+ * @param players A reference to the vector of Player objects to be ranked
+ * @return A DoubleEndedResult whose
+ * - top_    -> Contains the top 10% of players from the input in sorted order (ascending)
+ * - bottom_ -> Contains the bottom 10% of players from the input in sorted order (ascending)
+ * Both cutoffs_ are empty, & both elapsed_ hold the duration (ms) of the whole operation.
+ *
+ * @post The order of the parameter vector is modified.
+ */
+DoubleEndedResult dualSelectRank(std::vector<Player>& players) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    size_t N = players.size();
+    size_t k = N / 10;
+
+    //Select the last index of the bottom 10% & the first index of the top 10% together
+    if (k > 0) {
+        size_t targets[2] = { k - 1, N - k };
+        dualSelect(players, 0, static_cast<ptrdiff_t>(N), targets, targets + 2);
+    }
+
+    std::vector<Player> bottomPlayers(players.begin(), players.begin() + k);
+    std::vector<Player> topPlayers(players.end() - k, players.end());
+    std::sort(bottomPlayers.begin(), bottomPlayers.end());
+    std::sort(topPlayers.begin(), topPlayers.end());
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return DoubleEndedResult { RankingResult(topPlayers, {}, elapsed), RankingResult(bottomPlayers, {}, elapsed) };
+}
+};
+
+namespace Online {
+/**
+ * @brief The max-heap counterpart of `replaceMin()`: replaces the maximum element
+ * of a max-heap with a target value & percolates it down to its correct position.
+ *
+ * @pre The range [first, last) is a max-heap.
+ *
+ * @param first An iterator to the root of the max-heap
+ * @param last An iterator one past the end of the max-heap
+ * @param target A reference to a Player object to be inserted into the heap
+ */
+void replaceMax(PlayerIt first, PlayerIt last, Player& target) {
+    replaceRoot(first, last, target, std::less<Player>());
+}
+
+/**
+ * @brief Exhausts a stream of Players once, maintaining both the <reporting_interval>
+ *        highest & the <reporting_interval> lowest leveled Players.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels,
+ *        & the size of each leaderboard
+ * @return A DoubleEndedResult whose
+ * - top_    -> Is as returned by `rankIncoming()`
+ * - bottom_ -> Contains the bottom <reporting_interval> Players in sorted (least to greatest)
+ *              order, with cutoffs_ mapping milestones to the maximum level in the bottom
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+DoubleEndedResult rankIncomingBothEnds(PlayerStream& stream, const size_t& reporting_interval) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //A min-heap for the top & a max-heap for the bottom, fed by one pass
+    std::vector<Player> topPlayers;
+    std::vector<Player> bottomPlayers;
+    std::unordered_map<size_t, size_t> topCutoffs;
+    std::unordered_map<size_t, size_t> bottomCutoffs;
+    size_t playerCount = 0;
+
+    //Process the stream until no players remain
+    while (stream.remaining() > 0) {
+        Player currentPlayer = stream.nextPlayer();
+        playerCount++;
+
+        if (topPlayers.size() < reporting_interval) {
+            topPlayers.push_back(currentPlayer);
+            bottomPlayers.push_back(currentPlayer);
+            if (topPlayers.size() == reporting_interval) {
+                std::make_heap(topPlayers.begin(), topPlayers.end(), std::greater<Player>());
+                std::make_heap(bottomPlayers.begin(), bottomPlayers.end());
+            }
+        } else {
+            //Both ends are checked, as they overlap until 2 * <reporting_interval> players are read
+            if (currentPlayer < bottomPlayers.front()) {
+                Player copy = currentPlayer;
+                replaceMax(bottomPlayers.begin(), bottomPlayers.end(), copy);
+            }
+            if (currentPlayer > topPlayers.front()) {
+                replaceMin(topPlayers.begin(), topPlayers.end(), currentPlayer);
+            }
+        }
+
+        if (playerCount % reporting_interval == 0) {
+            topCutoffs[playerCount] = topPlayers.front().level_;
+            bottomCutoffs[playerCount] = bottomPlayers.front().level_;
+        }
+    }
+
+    // Record cutoffs for total players if not already recorded
+    if (!topPlayers.empty() && topCutoffs.find(playerCount) == topCutoffs.end()) {
+        topCutoffs[playerCount] = std::min_element(topPlayers.begin(), topPlayers.end())->level_;
+        bottomCutoffs[playerCount] = std::max_element(bottomPlayers.begin(), bottomPlayers.end())->level_;
+    }
+
+    //Sort both ends in ascending order
+    std::sort(topPlayers.begin(), topPlayers.end());
+    std::sort(bottomPlayers.begin(), bottomPlayers.end());
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return DoubleEndedResult { RankingResult(topPlayers, topCutoffs, elapsed), RankingResult(bottomPlayers, bottomCutoffs, elapsed) };
+}
+};
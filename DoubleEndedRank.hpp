@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+/**
+ * @brief The result of ranking both ends of a collection of Players at once.
+ */
+struct DoubleEndedResult {
+    /**
+     * @brief The highest leveled Players, as for a single-ended ranking.
+     *
+     * top_.cutoffs_ maps player count milestones to the minimum level required
+     * to be among the top Players at that point (online only).
+     */
+    RankingResult top_;
+
+    /**
+     * @brief The lowest leveled Players, sorted in ascending order by level
+     *        (lowest level first, highest level last).
+     *
+     * bottom_.cutoffs_ maps player count milestones to the maximum level at which
+     * a Player is still among the bottom Players at that point (online only).
+     */
+    RankingResult bottom_;
+};
+
+namespace Offline {
+/**
+ * @brief Uses a dual-pivot quickselect to select both the top 10% & the bottom 10%
+ *        of players in a single partitioning pass, then sorts each end.
+ *
+ * Each round partitions around two pivots into three segments, & only descends into
+ * the segment(s) holding the two boundary ranks. While both ranks fall in the same
+ * segment the two selections share every pass over the data; they only split once
+ * a pair of pivots separates them.
+ *
+ * @param players A reference to the vector of Player objects to be ranked
+ * @return A DoubleEndedResult whose
+ * - top_    -> Contains the top 10% of players from the input in sorted order (ascending)
+ * - bottom_ -> Contains the bottom 10% of players from the input in sorted order (ascending)
+ * Both cutoffs_ are empty, & both elapsed_ hold the duration (ms) of the whole operation.
+ *
+ * @post The order of the parameter vector is modified.
+ */
+DoubleEndedResult dualSelectRank(std::vector<Player>& players);
+};
+
+namespace Online {
+/**
+ * @brief The max-heap counterpart of `replaceMin()`: replaces the maximum element
+ * of a max-heap with a target value & percolates it down to its correct position.
+ *
+ * Performs in O(log N) time.
+ *
+ * @pre The range [first, last) is a max-heap.
+ *
+ * @param first An iterator to the root of the max-heap
+ * @param last An iterator one past the end of the max-heap
+ * @param target A reference to a Player object to be inserted into the heap
+ * @post
+ * - The vector slice denoted from [first,last) is a max-heap
+ *   into which `target` has been inserted.
+ * - The contents of `target` is not guaranteed to match its original state
+ *   (ie. you may move it).
+ */
+void replaceMax(PlayerIt first, PlayerIt last, Player& target);
+
+/**
+ * @brief Exhausts a stream of Players once, maintaining both the <reporting_interval>
+ *        highest & the <reporting_interval> lowest leveled Players.
+ *
+ * Each Player is compared against the top cutoff (the root of a min-heap, via
+ * `replaceMin()`) & the bottom ceiling (the root of a max-heap, via `replaceMax()`),
+ * so both leaderboards come out of one pass over the stream rather than two.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels,
+ *        & the size of each leaderboard
+ * @return A DoubleEndedResult whose
+ * - top_    -> Is as returned by `rankIncoming()`
+ * - bottom_ -> Contains the bottom <reporting_interval> Players in sorted (least to greatest)
+ *              order, with cutoffs_ mapping milestones to the maximum level in the bottom
+ * Both elapsed_ hold the duration (ms) of the whole operation, excluding fetching players.
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+DoubleEndedResult rankIncomingBothEnds(PlayerStream& stream, const size_t& reporting_interval);
+};
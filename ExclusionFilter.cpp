@@ -0,0 +1,145 @@
+#include "ExclusionFilter.hpp"
+#include "Hash.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Constructs a filter for the given excluded ids.
+ *
+ * @param ids The ids to be excluded (duplicates are allowed)
+ */
+ExclusionFilter::ExclusionFilter(const std::vector<size_t>& ids)
+    : ids_(ids.begin(), ids.end())
+    , seed_ { 0 }
+    , blockLength_ { 0 }
+{
+    //Duplicates can never be peeled, so deduplicate first
+    std::sort(ids_.begin(), ids_.end());
+    ids_.erase(std::unique(ids_.begin(), ids_.end()), ids_.end());
+
+    if (ids_.empty()) {
+        return;
+    }
+
+    //~1.23 slots per id, split into three blocks, is enough to peel with high probability
+    size_t capacity = 32 + (ids_.size() * 123) / 100;
+    blockLength_ = static_cast<uint32_t>(capacity / 3);
+
+    //Retry under a new seed on the (rare) failure to peel
+    while (!build()) {
+        seed_++;
+    }
+}
+
+/**
+ * @brief Hashes an id under the current seed.
+ */
+uint64_t ExclusionFilter::hash(const uint64_t& id) const {
+    return Hash::mix64(id + Hash::mix64(seed_));
+}
+
+/**
+ * @brief Computes the three fingerprint slots of a hashed id.
+ */
+void ExclusionFilter::slots(const uint64_t& hash, uint32_t (&slot)[3]) const {
+    slot[0] = Hash::reduce(static_cast<uint32_t>(hash), blockLength_);
+    slot[1] = Hash::reduce(static_cast<uint32_t>(Hash::rotl64(hash, 21)), blockLength_) + blockLength_;
+    slot[2] = Hash::reduce(static_cast<uint32_t>(Hash::rotl64(hash, 42)), blockLength_) + 2 * blockLength_;
+}
+
+/**
+ * @brief Attempts to build the fingerprints under the current seed.
+ *
+ * Every slot keeps a count & the xor of the hashes mapped to it. Slots hit by
+ * a single hash are peeled off (together with that hash) until either no
+ * hashes remain (success) or no slot has a count of one (failure).
+ *
+ * @return true if every id could be assigned a slot, false otherwise
+ */
+bool ExclusionFilter::build() {
+    size_t size = 3 * static_cast<size_t>(blockLength_);
+    std::vector<uint64_t> xorMask(size, 0);
+    std::vector<uint32_t> count(size, 0);
+    uint32_t slot[3];
+
+    for (const uint64_t& id : ids_) {
+        uint64_t h = hash(id);
+        slots(h, slot);
+        for (uint32_t s : slot) {
+            xorMask[s] ^= h;
+            count[s]++;
+        }
+    }
+
+    //Queue every slot with a single hash mapped to it
+    std::vector<uint32_t> queue;
+    for (size_t s = 0; s < size; ++s) {
+        if (count[s] == 1) {
+            queue.push_back(static_cast<uint32_t>(s));
+        }
+    }
+
+    //Peel, recording (hash, slot) pairs in the order they were freed
+    std::vector<std::pair<uint64_t, uint32_t>> stack;
+    stack.reserve(ids_.size());
+    while (!queue.empty()) {
+        uint32_t s = queue.back();
+        queue.pop_back();
+        if (count[s] != 1) {
+            continue;
+        }
+
+        uint64_t h = xorMask[s];
+        stack.emplace_back(h, s);
+        slots(h, slot);
+        for (uint32_t other : slot) {
+            xorMask[other] ^= h;
+            if (--count[other] == 1) {
+                queue.push_back(other);
+            }
+        }
+    }
+
+    if (stack.size() != ids_.size()) {
+        return false;
+    }
+
+    //Assign in reverse peeling order, so each slot is the last one written for its hash
+    fingerprints_.assign(size, 0);
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+        slots(it->first, slot);
+        uint8_t fingerprint = static_cast<uint8_t>(it->first ^ (it->first >> 32));
+        fingerprints_[it->second] = 0;
+        fingerprints_[it->second] = fingerprint ^ fingerprints_[slot[0]] ^ fingerprints_[slot[1]] ^ fingerprints_[slot[2]];
+    }
+    return true;
+}
+
+/**
+ * @brief Returns whether an id *may* be excluded.
+ */
+bool ExclusionFilter::mayContain(const size_t& id) const {
+    if (ids_.empty()) {
+        return false;
+    }
+
+    uint64_t h = hash(id);
+    uint32_t slot[3];
+    slots(h, slot);
+    uint8_t fingerprint = static_cast<uint8_t>(h ^ (h >> 32));
+    return fingerprint == (fingerprints_[slot[0]] ^ fingerprints_[slot[1]] ^ fingerprints_[slot[2]]);
+}
+
+/**
+ * @brief Returns whether an id is excluded, exactly.
+ */
+bool ExclusionFilter::contains(const size_t& id) const {
+    return mayContain(id) && std::binary_search(ids_.begin(), ids_.end(), static_cast<uint64_t>(id));
+}
+
+/**
+ * @brief Returns the number of distinct excluded ids.
+ */
+size_t ExclusionFilter::size() const {
+    return ids_.size();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A static set of excluded (ie. banned or hidden) Player ids.
+ *
+ * Membership is answered in two stages:
+ * 1) An xor filter with 8-bit fingerprints (~1.23 bytes per id) which
+ *    answers "definitely not excluded" for all but ~0.4% of other ids
+ *    using three reads into one small array.
+ * 2) An exact confirmation against a sorted copy of the ids, only
+ *    ever performed for ids that pass the filter.
+ *
+ * Rankers only consult the filter for Players that would actually enter the
+ * leaderboard (ie. survivors above the cutoff), so the common below-cutoff
+ * Player never pays for an exclusion check at all.
+ *
+ * @example Suppose the banned ids are { 3, 17 }. Then:
+ *
+ * filter.contains(17) -> true
+ * filter.contains(4)  -> false (almost always decided by the fingerprints alone)
+ */
+class ExclusionFilter {
+private:
+    std::vector<uint8_t> fingerprints_; //Three equal blocks of the xor filter
+    std::vector<uint64_t> ids_; //Sorted, deduplicated excluded ids, for exact confirmation
+    uint64_t seed_; //Seed under which the filter was successfully built
+    uint32_t blockLength_; //The length of each of the three fingerprint blocks
+
+    /**
+     * @brief Hashes an id under the current seed.
+     */
+    uint64_t hash(const uint64_t& id) const;
+
+    /**
+     * @brief Computes the three fingerprint slots of a hashed id.
+     */
+    void slots(const uint64_t& hash, uint32_t (&slot)[3]) const;
+
+    /**
+     * @brief Attempts to build the fingerprints under the current seed.
+     *
+     * @return true if every id could be assigned a slot, false otherwise
+     */
+    bool build();
+
+public:
+    /**
+     * @brief Constructs a filter for the given excluded ids.
+     *
+     * Performs in expected O(N) time.
+     *
+     * @param ids The ids to be excluded (duplicates are allowed)
+     */
+    ExclusionFilter(const std::vector<size_t>& ids = {});
+
+    /**
+     * @brief Returns whether an id *may* be excluded.
+     *
+     * Never returns false for an excluded id, & returns true for
+     * roughly 1 in 256 ids which are not excluded.
+     */
+    bool mayContain(const size_t& id) const;
+
+    /**
+     * @brief Returns whether an id is excluded, exactly.
+     *
+     * Consults the fingerprints first, & only confirms the (rare) positives
+     * by a binary search of the excluded ids.
+     */
+    bool contains(const size_t& id) const;
+
+    /**
+     * @brief Returns the number of distinct excluded ids.
+     */
+    size_t size() const;
+};
@@ -0,0 +1,248 @@
+#include "GroupAggregate.hpp"
+#include "Hash.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+constexpr size_t PREFETCH_DISTANCE = 16; //How many adds ahead to prefetch a group's slot
+
+/**
+ * @brief Orders aggregates by score, for selection & sorting.
+ */
+struct ByScore {
+    AggregateBy by_;
+
+    bool operator()(const GroupAggregate& a, const GroupAggregate& b) const {
+        return a.score(by_) < b.score(by_);
+    }
+};
+
+/**
+ * @brief Keeps the best `k` of a collection of aggregates, in sorted (ascending) order.
+ */
+void keepTop(std::vector<GroupAggregate>& aggregates, const size_t& k, const AggregateBy& by) {
+    if (aggregates.size() > k) {
+        std::nth_element(aggregates.begin(), aggregates.end() - k, aggregates.end(), ByScore { by });
+        aggregates.erase(aggregates.begin(), aggregates.end() - k);
+    }
+    std::sort(aggregates.begin(), aggregates.end(), ByScore { by });
+}
+};
+
+/**
+ * @brief Returns the value of this aggregate by which groups are ranked.
+ */
+double GroupAggregate::score(const AggregateBy& by) const {
+    switch (by) {
+    case AggregateBy::Count:
+        return static_cast<double>(count_);
+    case AggregateBy::Average:
+        return count_ == 0 ? 0 : static_cast<double>(sum_) / count_;
+    default:
+        return static_cast<double>(sum_);
+    }
+}
+
+/**
+ * @brief Constructs an empty table, sized for `expected_groups` groups.
+ */
+AggregateTable::AggregateTable(const size_t& expected_groups)
+    : size_ { 0 }
+{
+    size_t slots = 16;
+    while (slots * 7 < expected_groups * 10) {
+        slots *= 2;
+    }
+    slots_.assign(slots, GroupAggregate { EMPTY, 0, 0 });
+}
+
+/**
+ * @brief Returns the index of a group's slot, or of the empty slot where it belongs.
+ */
+size_t AggregateTable::probe(const std::vector<GroupAggregate>& slots, const size_t& group) const {
+    size_t mask = slots.size() - 1;
+    size_t i = Hash::mix64(group) & mask;
+    while (slots[i].group_ != EMPTY && slots[i].group_ != group) {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+/**
+ * @brief Doubles the table, re-inserting every group.
+ */
+void AggregateTable::grow() {
+    std::vector<GroupAggregate> slots(slots_.size() * 2, GroupAggregate { EMPTY, 0, 0 });
+    for (const GroupAggregate& slot : slots_) {
+        if (slot.group_ != EMPTY) {
+            slots[probe(slots, slot.group_)] = slot;
+        }
+    }
+    slots_.swap(slots);
+}
+
+/**
+ * @brief Adds one member's level to its group's aggregate.
+ *
+ * @param group The id of the member's group (any but EMPTY, ie. ~0)
+ * @param level The member's level
+ *
+ * @throws std::invalid_argument If the group id is EMPTY.
+ */
+void AggregateTable::add(const size_t& group, const size_t& level) {
+    if (group == EMPTY) {
+        throw std::invalid_argument("Group id ~0 is reserved");
+    }
+    if ((size_ + 1) * 10 > slots_.size() * 7) {
+        grow();
+    }
+
+    GroupAggregate& slot = slots_[probe(slots_, group)];
+    if (slot.group_ == EMPTY) {
+        slot.group_ = group;
+        size_++;
+    }
+    slot.sum_ += level;
+    slot.count_++;
+}
+
+/**
+ * @brief Hints that a group will soon be added to, prefetching its home slot.
+ */
+void AggregateTable::prefetch(const size_t& group) const {
+    __builtin_prefetch(&slots_[Hash::mix64(group) & (slots_.size() - 1)]);
+}
+
+/**
+ * @brief Returns a group's aggregate (with a count of 0 if it was never added to).
+ */
+GroupAggregate AggregateTable::find(const size_t& group) const {
+    const GroupAggregate& slot = slots_[probe(slots_, group)];
+    return slot.group_ == EMPTY ? GroupAggregate { group, 0, 0 } : slot;
+}
+
+/**
+ * @brief Returns the number of groups held.
+ */
+size_t AggregateTable::size() const {
+    return size_;
+}
+
+/**
+ * @brief Selects the `k` groups of highest aggregate, without building any Players.
+ *
+ * @param k The number of groups to keep
+ * @param by The aggregate to rank by
+ * @return The top `k` groups in sorted (least to greatest) order by score
+ */
+std::vector<GroupAggregate> AggregateTable::top(const size_t& k, const AggregateBy& by) const {
+    if (k == 0 || size_ == 0) {
+        return {};
+    }
+
+    //Score every slot in one branch-free pass (empty slots have a count of 0)
+    size_t slots = slots_.size();
+    std::vector<double> scores(slots);
+    const GroupAggregate* slot = slots_.data();
+    for (size_t i = 0; i < slots; ++i) {
+        double sum = static_cast<double>(slot[i].sum_);
+        double count = static_cast<double>(slot[i].count_);
+        scores[i] = by == AggregateBy::Sum ? sum : by == AggregateBy::Count ? count : sum / (count > 0 ? count : 1);
+    }
+
+    //Select the k best scores among occupied slots, then copy out only those groups
+    std::vector<size_t> occupied;
+    occupied.reserve(size_);
+    for (size_t i = 0; i < slots; ++i) {
+        if (slot[i].group_ != EMPTY) {
+            occupied.push_back(i);
+        }
+    }
+    size_t keep = std::min(k, occupied.size());
+    std::nth_element(occupied.begin(), occupied.end() - keep, occupied.end(), [&](size_t a, size_t b) {
+        return scores[a] < scores[b];
+    });
+
+    std::vector<GroupAggregate> top;
+    top.reserve(keep);
+    for (auto it = occupied.end() - keep; it != occupied.end(); ++it) {
+        top.push_back(slot[*it]);
+    }
+    std::sort(top.begin(), top.end(), ByScore { by });
+    return top;
+}
+
+namespace Offline {
+/**
+ * @brief Ranks the groups of a collection of Players by an aggregate of their members'
+ *        levels, aggregating (& selecting) each partition of the groups in parallel.
+ *
+ * @param players The Players to be aggregated
+ * @param groups The id of the group of each Player (ie. groups[i] is that of players[i])
+ * @param k The number of groups to keep
+ * @param by The aggregate to rank by
+ * @param threads The number of threads to use (0 for the hardware concurrency)
+ * @return A GroupRankingResult of the top `k` groups
+ *
+ * @throws std::invalid_argument If any group id is `AggregateTable::EMPTY` (ie. ~0).
+ */
+GroupRankingResult aggregateRank(const std::vector<Player>& players, const std::vector<size_t>& groups, const size_t& k, const AggregateBy& by, unsigned threads) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    threads = threads == 0 ? Parallel::defaultThreads() : threads;
+    std::vector<std::vector<GroupAggregate>> tops;
+
+    if (threads == 1) {
+        //A single partition: aggregate in place, skipping the scatter
+        AggregateTable table;
+        for (size_t i = 0; i < players.size(); ++i) {
+            if (i + PREFETCH_DISTANCE < players.size()) {
+                table.prefetch(groups[i + PREFETCH_DISTANCE]);
+            }
+            table.add(groups[i], players[i].level_);
+        }
+        tops.push_back(table.top(k, by));
+    } else {
+        //Reject the reserved id here, as add() cannot throw across the worker threads
+        if (std::find(groups.begin(), groups.begin() + players.size(), AggregateTable::EMPTY) != groups.begin() + players.size()) {
+            throw std::invalid_argument("Group id ~0 is reserved");
+        }
+
+        size_t parts = static_cast<size_t>(threads) * 4;
+        Parallel::Partitions partitions = Parallel::partition(players.size(), parts, threads, [&](size_t i) {
+            return Parallel::partitionOf(groups[i], parts);
+        });
+
+        //Aggregate each partition on its own, keeping only its top k
+        tops.resize(parts);
+        Parallel::forChunks(parts, threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t p = begin; p < end; ++p) {
+                AggregateTable table;
+                for (size_t j = partitions.offsets_[p]; j < partitions.offsets_[p + 1]; ++j) {
+                    if (j + PREFETCH_DISTANCE < partitions.offsets_[p + 1]) {
+                        table.prefetch(groups[partitions.indices_[j + PREFETCH_DISTANCE]]);
+                    }
+                    size_t i = partitions.indices_[j];
+                    table.add(groups[i], players[i].level_);
+                }
+                tops[p] = table.top(k, by);
+            }
+        });
+    }
+
+    std::vector<GroupAggregate> top;
+    for (const std::vector<GroupAggregate>& partitionTop : tops) {
+        top.insert(top.end(), partitionTop.begin(), partitionTop.end());
+    }
+    keepTop(top, k, by);
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return GroupRankingResult { top, elapsed };
+}
+};
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The aggregate by which groups are ranked.
+ */
+enum class AggregateBy {
+    Sum, //The sum of the members' levels
+    Count, //The number of members
+    Average //The mean of the members' levels
+};
+
+/**
+ * @brief The aggregate levels of one group's members.
+ */
+struct GroupAggregate {
+    size_t group_; //The id of the group
+    uint64_t sum_; //The sum of its members' levels
+    uint64_t count_; //The number of its members
+
+    /**
+     * @brief Returns the value of this aggregate by which groups are ranked.
+     */
+    double score(const AggregateBy& by) const;
+};
+
+/**
+ * @brief A result of ranking groups by an aggregate.
+ */
+struct GroupRankingResult {
+    std::vector<GroupAggregate> top_; //The top groups in sorted (least to greatest) order by score
+    double elapsed_; //Duration (ms) of the aggregation & selection
+};
+
+/**
+ * @brief A hash-aggregation table of the sum & count of levels per group.
+ *
+ * Groups are found by linear probing on `Hash::mix64()` of their id in a
+ * power-of-two table of 24-byte slots, so an add touches one cache line
+ * (rather than one per node, as `std::unordered_map` does). Scoring every group
+ * (see `top()`) is a single branch-free pass over the slots, & only the `k`
+ * selected groups are copied out. The table doubles once 70% full.
+ */
+class AggregateTable {
+public:
+    static constexpr size_t EMPTY = ~size_t(0); //Marks an empty slot (so this group id is reserved)
+
+private:
+    std::vector<GroupAggregate> slots_; //The table; an empty slot has a group_ of EMPTY
+    size_t size_; //The number of groups held
+
+    /**
+     * @brief Returns the index of a group's slot, or of the empty slot where it belongs.
+     */
+    size_t probe(const std::vector<GroupAggregate>& slots, const size_t& group) const;
+
+    /**
+     * @brief Doubles the table, re-inserting every group.
+     */
+    void grow();
+
+public:
+    /**
+     * @brief Constructs an empty table, sized for `expected_groups` groups.
+     */
+    AggregateTable(const size_t& expected_groups = 0);
+
+    /**
+     * @brief Adds one member's level to its group's aggregate.
+     *
+     * @param group The id of the member's group (any but EMPTY, ie. ~0)
+     * @param level The member's level
+     *
+     * @throws std::invalid_argument If the group id is EMPTY.
+     */
+    void add(const size_t& group, const size_t& level);
+
+    /**
+     * @brief Hints that a group will soon be added to, prefetching its home slot so that
+     *        the cache miss overlaps with the adds before it.
+     */
+    void prefetch(const size_t& group) const;
+
+    /**
+     * @brief Returns a group's aggregate (with a count of 0 if it was never added to).
+     */
+    GroupAggregate find(const size_t& group) const;
+
+    /**
+     * @brief Returns the number of groups held.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Selects the `k` groups of highest aggregate, without building any Players.
+     *
+     * @param k The number of groups to keep
+     * @param by The aggregate to rank by
+     * @return The top `k` groups in sorted (least to greatest) order by score
+     */
+    std::vector<GroupAggregate> top(const size_t& k, const AggregateBy& by) const;
+};
+
+namespace Offline {
+/**
+ * @brief Ranks the groups of a collection of Players by an aggregate of their members'
+ *        levels, replacing an `std::unordered_map` pass followed by ranking synthetic Players.
+ *
+ * The Players are radix-partitioned by (a hash of) their group id (see
+ * `Parallel::partition()`), so each group lies wholly within one partition.
+ * Each thread aggregates its partitions into their own AggregateTables & selects
+ * their top `k`; the per-partition tops are then merged into the overall top `k`.
+ *
+ * @param players The Players to be aggregated
+ * @param groups The id of the group of each Player (ie. groups[i] is that of players[i])
+ * @param k The number of groups to keep
+ * @param by The aggregate to rank by
+ * @param threads The number of threads to use (0 for the hardware concurrency)
+ * @return A GroupRankingResult of the top `k` groups
+ *
+ * @throws std::invalid_argument If any group id is `AggregateTable::EMPTY` (ie. ~0).
+ */
+GroupRankingResult aggregateRank(const std::vector<Player>& players, const std::vector<size_t>& groups, const size_t& k, const AggregateBy& by, unsigned threads = 0);
+};
+
+namespace Online {
+/**
+ * @brief Exhausts a stream of Players, aggregating their levels by group.
+ *
+ * @param stream A stream providing Player objects
+ * @param group_of A callable mapping a Player to the id of its group
+ * @param expected_groups The number of groups expected (to avoid regrowing)
+ * @return The aggregate of every group seen (see `AggregateTable::top()` to rank them)
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ *
+ * @throws std::invalid_argument If a Player's group id is `AggregateTable::EMPTY` (ie. ~0).
+ */
+template <typename GroupOf>
+AggregateTable aggregateIncoming(PlayerStream& stream, GroupOf group_of, const size_t& expected_groups = 0) {
+    AggregateTable table(expected_groups);
+    while (stream.remaining() > 0) {
+        Player currentPlayer = stream.nextPlayer();
+        table.add(group_of(currentPlayer), currentPlayer.level_);
+    }
+    return table;
+}
+};
@@ -0,0 +1,273 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+#include "Hash.hpp"
+#include "Parallel.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief A compact leaderboard entry: a Player's level & id, without its name.
+ */
+struct GroupEntry {
+    size_t level_;
+    size_t id_;
+};
+
+namespace Online {
+/**
+ * @brief A top-K of Players for each of (possibly millions of) small groups, eg. the
+ *        top 5 of every guild, kept in one flat open-addressing table.
+ *
+ * Each slot holds a group id & up to K GroupEntries inline, sorted in ascending order
+ * by level, so there is no per-group allocation (as a heap vector per group would need)
+ * & a group's entries share its cache lines. Groups are found by linear probing on
+ * `Hash::mix64()` of their id; the table doubles once 70% full.
+ *
+ * As K is small, an accepted entry is inserted by shifting the (at most K) entries
+ * below it, & the cutoff of a full group is simply its first entry.
+ *
+ * @tparam K The number of Players to keep per group
+ *
+ * @example With K = 2, offering (guild 7, level 5), (guild 7, level 9), (guild 3, level 1),
+ * (guild 7, level 6) leaves guild 7 with { 6, 9 } & guild 3 with { 1 }.
+ */
+template <size_t K>
+class GroupedTopK {
+private:
+    /**
+     * @brief A table slot; empty while count_ is 0.
+     */
+    struct Slot {
+        size_t group_;
+        uint32_t count_;
+        GroupEntry entries_[K]; //Ascending by level
+    };
+
+    std::vector<Slot> slots_; //The table, a power of two in size
+    size_t size_; //The number of groups held
+
+    /**
+     * @brief Returns the slot of a group, or the empty slot where it belongs.
+     */
+    Slot& probe(std::vector<Slot>& slots, const size_t& group) {
+        size_t mask = slots.size() - 1;
+        size_t i = Hash::mix64(group) & mask;
+        while (slots[i].count_ != 0 && slots[i].group_ != group) {
+            i = (i + 1) & mask;
+        }
+        return slots[i];
+    }
+
+    /**
+     * @brief Doubles the table, re-inserting every group.
+     */
+    void grow() {
+        std::vector<Slot> slots(slots_.size() * 2, Slot {});
+        for (const Slot& slot : slots_) {
+            if (slot.count_ != 0) {
+                probe(slots, slot.group_) = slot;
+            }
+        }
+        slots_.swap(slots);
+    }
+
+public:
+    /**
+     * @brief Constructs an empty table, sized for `expected_groups` groups.
+     *
+     * @param expected_groups The number of groups expected (to avoid regrowing)
+     */
+    GroupedTopK(const size_t& expected_groups = 0)
+        : size_ { 0 }
+    {
+        size_t slots = 16;
+        while (slots * 7 < expected_groups * 10) {
+            slots *= 2;
+        }
+        slots_.assign(slots, Slot {});
+    }
+
+    /**
+     * @brief Offers a Player to its group's top-K.
+     *
+     * @param group The id of the Player's group
+     * @param player A reference to the Player to be offered
+     * @return true if the Player was kept, false otherwise
+     */
+    bool offer(const size_t& group, const Player& player) {
+        if (K == 0) {
+            return false;
+        }
+        if ((size_ + 1) * 10 > slots_.size() * 7) {
+            grow();
+        }
+
+        Slot& slot = probe(slots_, group);
+        if (slot.count_ == 0) {
+            slot.group_ = group;
+            size_++;
+        }
+
+        //Find the insertion point, dropping the minimum if the group is full
+        size_t i = slot.count_;
+        if (slot.count_ == K) {
+            if (player.level_ <= slot.entries_[0].level_) {
+                return false;
+            }
+            i = 0;
+            while (i + 1 < K && slot.entries_[i + 1].level_ < player.level_) {
+                slot.entries_[i] = slot.entries_[i + 1];
+                i++;
+            }
+        } else {
+            while (i > 0 && slot.entries_[i - 1].level_ > player.level_) {
+                slot.entries_[i] = slot.entries_[i - 1];
+                i--;
+            }
+            slot.count_++;
+        }
+
+        slot.entries_[i] = GroupEntry { player.level_, player.id_ };
+        return true;
+    }
+
+    /**
+     * @brief Returns a group's top-K in sorted (least to greatest) order
+     *        (empty if no Player of the group was offered).
+     */
+    std::vector<GroupEntry> top(const size_t& group) const {
+        size_t mask = slots_.size() - 1;
+        size_t i = Hash::mix64(group) & mask;
+        while (slots_[i].count_ != 0) {
+            if (slots_[i].group_ == group) {
+                return std::vector<GroupEntry>(slots_[i].entries_, slots_[i].entries_ + slots_[i].count_);
+            }
+            i = (i + 1) & mask;
+        }
+        return {};
+    }
+
+    /**
+     * @brief Calls `visit(group, entries, count)` for every group held, where
+     *        entries points to its `count` GroupEntries in ascending order.
+     */
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const Slot& slot : slots_) {
+            if (slot.count_ != 0) {
+                visit(slot.group_, slot.entries_, static_cast<size_t>(slot.count_));
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of groups held.
+     */
+    size_t size() const {
+        return size_;
+    }
+
+    /**
+     * @brief Returns the memory held by the table, in bytes.
+     */
+    size_t bytes() const {
+        return slots_.size() * sizeof(Slot);
+    }
+};
+
+/**
+ * @brief Exhausts a stream of Players, keeping the top K Players of each group.
+ *
+ * @tparam K The number of Players to keep per group
+ * @param stream A stream providing Player objects
+ * @param group_of A callable mapping a Player to the id of its group
+ * @param expected_groups The number of groups expected (to avoid regrowing)
+ * @return The top-K of every group seen
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+template <size_t K, typename GroupOf>
+GroupedTopK<K> rankIncomingGrouped(PlayerStream& stream, GroupOf group_of, const size_t& expected_groups = 0) {
+    GroupedTopK<K> table(expected_groups);
+    while (stream.remaining() > 0) {
+        Player currentPlayer = stream.nextPlayer();
+        table.offer(group_of(currentPlayer), currentPlayer);
+    }
+    return table;
+}
+};
+
+/**
+ * @brief The result of `Offline::groupedRank()`: one GroupedTopK per partition of the
+ *        group ids, such that every group lies wholly within one partition.
+ */
+template <size_t K>
+struct GroupedResult {
+    std::vector<Online::GroupedTopK<K>> partitions_; //The top-K of the groups of each partition
+    double elapsed_; //Duration (ms) of the partitioning & ranking
+
+    /**
+     * @brief Returns a group's top-K in sorted (least to greatest) order.
+     */
+    std::vector<GroupEntry> top(const size_t& group) const {
+        return partitions_[Parallel::partitionOf(group, partitions_.size())].top(group);
+    }
+
+    /**
+     * @brief Returns the number of groups held.
+     */
+    size_t size() const {
+        size_t groups = 0;
+        for (const Online::GroupedTopK<K>& partition : partitions_) {
+            groups += partition.size();
+        }
+        return groups;
+    }
+};
+
+namespace Offline {
+/**
+ * @brief Keeps the top K Players of each group of a collection, in parallel.
+ *
+ * The Players are radix-partitioned by (a hash of) their group id (see
+ * `Parallel::partition()`), so each group lies wholly within one partition.
+ * Each thread then runs its own partitions through a GroupedTopK, each of
+ * which only holds its share of the groups & so stays cache-resident longer.
+ *
+ * @tparam K The number of Players to keep per group
+ * @param players The Players to be ranked
+ * @param groups The id of the group of each Player (ie. groups[i] is that of players[i])
+ * @param threads The number of threads to use (0 for the hardware concurrency)
+ * @return The top-K of every group, by partition
+ */
+template <size_t K>
+GroupedResult<K> groupedRank(const std::vector<Player>& players, const std::vector<size_t>& groups, unsigned threads = 0) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    threads = threads == 0 ? Parallel::defaultThreads() : threads;
+    size_t parts = static_cast<size_t>(threads) * 4;
+
+    Parallel::Partitions partitions = Parallel::partition(players.size(), parts, threads, [&](size_t i) {
+        return Parallel::partitionOf(groups[i], parts);
+    });
+
+    GroupedResult<K> result { std::vector<Online::GroupedTopK<K>>(parts), 0 };
+    Parallel::forChunks(parts, threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t p = begin; p < end; ++p) {
+            for (size_t j = partitions.offsets_[p]; j < partitions.offsets_[p + 1]; ++j) {
+                size_t i = partitions.indices_[j];
+                result.partitions_[p].offer(groups[i], players[i]);
+            }
+        }
+    });
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    result.elapsed_ = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return result;
+}
+};
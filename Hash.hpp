@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace Hash {
+/**
+ * @brief Mixes the bits of a 64-bit key (the splitmix64 finalizer),
+ *        such that consecutive ids spread across the whole output range.
+ *
+ * @param key The value to be mixed
+ * @return A well-distributed 64-bit hash of `key`
+ */
+inline uint64_t mix64(uint64_t key) {
+    key += 0x9e3779b97f4a7c15ULL;
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+}
+
+/**
+ * @brief Hashes a run of bytes (eg. a Player name) to 64 bits,
+ *        eight bytes at a time.
+ *
+ * @param data A pointer to the first byte to hash
+ * @param length The number of bytes to hash
+ * @param seed An optional seed, to derive independent hash functions
+ * @return A well-distributed 64-bit hash of the bytes
+ */
+inline uint64_t bytes(const void* data, size_t length, uint64_t seed = 0) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h = mix64(seed ^ length);
+
+    while (length >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = mix64(h ^ word);
+        p += 8;
+        length -= 8;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, p, length);
+    return mix64(h ^ tail);
+}
+
+/**
+ * @brief Maps a 32-bit hash uniformly onto [0, n) without a division.
+ */
+inline uint32_t reduce(uint32_t hash, uint32_t n) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(hash) * n) >> 32);
+}
+
+/**
+ * @brief Rotates a 64-bit value left by `r` bits.
+ */
+inline uint64_t rotl64(uint64_t value, unsigned r) {
+    return (value << r) | (value >> ((64 - r) & 63));
+}
+};
@@ -0,0 +1,135 @@
+#include "IncrementalRanker.hpp"
+
+namespace Offline {
+/**
+ * @brief Constructs a ranker which has not yet ranked any table.
+ *
+ * @param reserve_ratio The fraction of the table to keep as candidates beyond the top 10%
+ * @param fallback_ratio The fraction of the table above which a change set
+ *        is ranked from scratch rather than incrementally
+ */
+IncrementalRanker::IncrementalRanker(const double& reserve_ratio, const double& fallback_ratio)
+    : reserveRatio_ { reserve_ratio }
+    , fallbackRatio_ { fallback_ratio }
+    , population_ { 0 }
+    , boundary_ { 0 }
+    , ranked_ { false }
+{
+}
+
+/**
+ * @brief Selects & sorts the top 10% of the candidate set.
+ */
+std::vector<Player> IncrementalRanker::selectTop() const {
+    std::vector<Player> candidates;
+    candidates.reserve(tracked_.size());
+    for (const auto& entry : tracked_) {
+        candidates.push_back(entry.second);
+    }
+
+    size_t topCount = std::min(population_ / 10, candidates.size());
+    std::nth_element(candidates.begin(), candidates.end() - topCount, candidates.end());
+    std::vector<Player> topPlayers(candidates.end() - topCount, candidates.end());
+    std::sort(topPlayers.begin(), topPlayers.end());
+    return topPlayers;
+}
+
+/**
+ * @brief Ranks a table from scratch (as `quickSelectRank()` does) & records
+ *        the candidate set for later incremental rankings.
+ *
+ * @param players A reference to the vector of Player objects to be ranked
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top 10% of players from the input in sorted order (ascending)
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+ *
+ * @post The order of the parameter vector is modified.
+ */
+RankingResult IncrementalRanker::rank(std::vector<Player>& players) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Select the top 10% plus the reserve in one partition
+    size_t N = players.size();
+    size_t reserve = static_cast<size_t>(N * reserveRatio_);
+    size_t candidates = std::min(N, N / 10 + reserve);
+    size_t k = N - candidates;
+    if (candidates > 0 && candidates < N) {
+        std::nth_element(players.begin(), players.begin() + k, players.end());
+    }
+
+    //Everything left behind is at most the lowest candidate
+    population_ = N;
+    boundary_ = candidates > 0 && candidates < N ? players[k].level_ : 0;
+    ranked_ = true;
+    tracked_.clear();
+    tracked_.reserve(candidates);
+    for (size_t i = k; i < N; ++i) {
+        tracked_[players[i].id_] = players[i];
+    }
+
+    std::vector<Player> topPlayers = selectTop();
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //Return the Ranking Result object
+    return RankingResult(topPlayers, {}, elapsed);
+}
+
+/**
+ * @brief Re-ranks a table given the Players whose level changed since the last ranking.
+ *
+ * @param players A reference to the vector of Player objects, already holding the
+ *        new levels. It is only read (& reordered) should a full ranking be needed.
+ * @param changes The Players whose level changed since the last call to `rank()` or `update()`
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top 10% of players from the input in sorted order (ascending)
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+ */
+RankingResult IncrementalRanker::update(std::vector<Player>& players, const std::vector<LevelChange>& changes) {
+    //Large change sets (or a changed table size) are cheaper to rank from scratch
+    if (!ranked_ || players.size() != population_ || changes.size() > fallbackRatio_ * population_) {
+        return rank(players);
+    }
+
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Fold every change into the candidate set, whether it rose or fell
+    for (const LevelChange& change : changes) {
+        if (change.player_.level_ != change.old_level_) {
+            tracked_[change.player_.id_] = change.player_;
+        }
+    }
+
+    //Candidates below the boundary can never outrank an untracked Player, so drop them
+    size_t atBoundary = 0;
+    for (auto it = tracked_.begin(); it != tracked_.end();) {
+        if (it->second.level_ < boundary_) {
+            it = tracked_.erase(it);
+        } else {
+            atBoundary++;
+            ++it;
+        }
+    }
+
+    //Too few candidates left at or above the boundary (or too many accumulated) to be exact
+    size_t reserve = static_cast<size_t>(population_ * reserveRatio_);
+    if (atBoundary < population_ / 10 || tracked_.size() > 2 * (population_ / 10 + reserve)) {
+        return rank(players);
+    }
+
+    std::vector<Player> topPlayers = selectTop();
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //Return the Ranking Result object
+    return RankingResult(topPlayers, {}, elapsed);
+}
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace Offline {
+/**
+ * @brief A change in level of a single Player since the previous ranking.
+ */
+struct LevelChange {
+    /**
+     * @brief The Player, as it is now (ie. holding its new level).
+     */
+    Player player_;
+
+    /**
+     * @brief The level of the Player at the time of the previous ranking.
+     */
+    size_t old_level_;
+};
+
+/**
+ * @brief Re-ranks the top 10% of a table of Players incrementally, from the
+ *        previous ranking plus the set of Players whose level changed since.
+ *
+ * A full ranking (`rank()`) selects the top 10% plus a reserve of the next best
+ * Players, & remembers the boundary level b at which it stopped: every Player
+ * outside of this candidate set has a level of at most b.
+ *
+ * An incremental ranking (`update()`) folds each changed Player into the
+ * candidate set. Unchanged Players outside of it are still at most b, so as long
+ * as the candidate set holds at least 10% of the table at a level of b or more,
+ * its top 10% is exactly the top 10% of the table, & no unchanged Player needs
+ * to be read. Otherwise (eg. more top Players fell than the reserve could
+ * replace), or when the change set is large, it falls back to a full ranking.
+ *
+ * @pre Player ids are unique within the table.
+ *
+ * @example Suppose last night's ranking covered 10M Players, & 200K changed level.
+ * Then update(players, changes) touches the ~1M candidates & the 200K changes only,
+ * rather than the full 10M Players.
+ */
+class IncrementalRanker {
+private:
+    double reserveRatio_; //The fraction of the table kept as candidates beyond the top 10%
+    double fallbackRatio_; //The fraction of the table above which a change set triggers a full ranking
+    size_t population_; //The number of Players in the table at the last full ranking
+    size_t boundary_; //Every Player outside of tracked_ has a level of at most boundary_
+    bool ranked_; //Whether a full ranking has been performed yet
+    std::unordered_map<size_t, Player> tracked_; //The candidate set, keyed by Player id
+
+    /**
+     * @brief Selects & sorts the top 10% of the candidate set.
+     */
+    std::vector<Player> selectTop() const;
+
+public:
+    /**
+     * @brief Constructs a ranker which has not yet ranked any table.
+     *
+     * @param reserve_ratio The fraction of the table to keep as candidates beyond the top 10%.
+     *        Larger reserves absorb more demotions before a full ranking is needed.
+     * @param fallback_ratio The fraction of the table above which a change set
+     *        is ranked from scratch rather than incrementally.
+     */
+    IncrementalRanker(const double& reserve_ratio = 0.02, const double& fallback_ratio = 0.1);
+
+    /**
+     * @brief Ranks a table from scratch (as `quickSelectRank()` does) & records
+     *        the candidate set for later incremental rankings.
+     *
+     * @param players A reference to the vector of Player objects to be ranked
+     * @return A Ranking Result object whose
+     * - top_ vector -> Contains the top 10% of players from the input in sorted order (ascending)
+     * - cutoffs_    -> Is empty
+     * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+     *
+     * @post The order of the parameter vector is modified.
+     */
+    RankingResult rank(std::vector<Player>& players);
+
+    /**
+     * @brief Re-ranks a table given the Players whose level changed since the last ranking.
+     *
+     * @param players A reference to the vector of Player objects, already holding the
+     *        new levels. It is only read (& reordered) should a full ranking be needed.
+     * @param changes The Players whose level changed since the last call to `rank()` or `update()`
+     * @return A Ranking Result object whose
+     * - top_ vector -> Contains the top 10% of players from the input in sorted order (ascending)
+     * - cutoffs_    -> Is empty
+     * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+     */
+    RankingResult update(std::vector<Player>& players, const std::vector<LevelChange>& changes);
+};
+};
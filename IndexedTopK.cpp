@@ -0,0 +1,192 @@
+#include "IndexedTopK.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+
+namespace Online {
+/**
+ * @brief Constructs an empty board holding at most `capacity` distinct Players.
+ *
+ * @param capacity The number of distinct Players to keep (ie. the k in top-k)
+ */
+IndexedTopK::IndexedTopK(const size_t& capacity)
+    : capacity_ { capacity }
+{
+    heap_.reserve(capacity);
+    slot_.reserve(capacity);
+}
+
+/**
+ * @brief Bulk-loads a board from Players sorted in ascending order by level
+ *        (eg. a restored snapshot), in O(N) time & with sequential writes.
+ *
+ * @param capacity The number of distinct Players to keep (ie. the k in top-k)
+ * @param sorted The Players to load, sorted in ascending order by level
+ */
+IndexedTopK::IndexedTopK(const size_t& capacity, const std::vector<Player>& sorted)
+    : IndexedTopK(capacity)
+{
+    //Walk down from the best Player, keeping the first (best) entry of each id
+    std::vector<size_t> kept;
+    kept.reserve(std::min(capacity, sorted.size()));
+    for (size_t i = sorted.size(); i > 0 && kept.size() < capacity_; --i) {
+        if (slot_.emplace(sorted[i - 1].id_, 0).second) {
+            kept.push_back(i - 1);
+        }
+    }
+
+    //Written back in ascending order, which is already a min-heap
+    for (size_t i = kept.size(); i > 0; --i) {
+        slot_[sorted[kept[i - 1]].id_] = heap_.size();
+        heap_.push_back(sorted[kept[i - 1]]);
+    }
+}
+
+/**
+ * @brief Bulk-loads a board from Players in any order, sorting them
+ *        in parallel (see `Parallel::sort()`) before loading.
+ *
+ * @param capacity The number of distinct Players to keep (ie. the k in top-k)
+ * @param players The Players to load, in any order
+ * @param threads The number of threads to sort with (0 for the hardware concurrency)
+ * @return The loaded board
+ */
+IndexedTopK IndexedTopK::fromUnsorted(const size_t& capacity, std::vector<Player> players, unsigned threads) {
+    Parallel::sort(players.begin(), players.end(), std::less<Player>(), threads == 0 ? Parallel::defaultThreads() : threads);
+    return IndexedTopK(capacity, players);
+}
+
+/**
+ * @brief Swaps two heap slots, keeping the id -> slot index in sync.
+ */
+void IndexedTopK::swapSlots(const size_t& a, const size_t& b) {
+    std::swap(heap_[a], heap_[b]);
+    slot_[heap_[a].id_] = a;
+    slot_[heap_[b].id_] = b;
+}
+
+/**
+ * @brief Percolates the Player at index i up towards the root
+ *        while it is smaller than its parent.
+ */
+void IndexedTopK::siftUp(size_t i) {
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!(heap_[i] < heap_[parent])) {
+            break;
+        }
+        swapSlots(i, parent);
+        i = parent;
+    }
+}
+
+/**
+ * @brief Percolates the Player at index i down towards the leaves
+ *        while one of its children is smaller than it.
+ */
+void IndexedTopK::siftDown(size_t i) {
+    size_t heapSize = heap_.size();
+
+    while (true) {
+        size_t leftChildIdx = 2 * i + 1;
+        size_t rightChildIdx = 2 * i + 2;
+        size_t smallest = i;
+
+        //Find the smallest among current, left child, and right child
+        if (leftChildIdx < heapSize && heap_[leftChildIdx] < heap_[smallest]) {
+            smallest = leftChildIdx;
+        }
+        if (rightChildIdx < heapSize && heap_[rightChildIdx] < heap_[smallest]) {
+            smallest = rightChildIdx;
+        }
+
+        if (smallest == i) {
+            break;
+        }
+
+        swapSlots(i, smallest);
+        i = smallest;
+    }
+}
+
+/**
+ * @brief Offers a Player to the board.
+ *
+ * @param player A reference to the Player to be offered
+ * @return true if the contents of the board changed, false otherwise
+ */
+bool IndexedTopK::offer(const Player& player) {
+    if (capacity_ == 0) {
+        return false;
+    }
+
+    //Repeated Player: keep its best level, raising it in place
+    auto found = slot_.find(player.id_);
+    if (found != slot_.end()) {
+        size_t i = found->second;
+        if (!(player > heap_[i])) {
+            return false;
+        }
+        heap_[i] = player;
+        siftDown(i); //A larger key can only move down a min-heap
+        return true;
+    }
+
+    //Board still has room, so append & percolate up
+    if (heap_.size() < capacity_) {
+        slot_[player.id_] = heap_.size();
+        heap_.push_back(player);
+        siftUp(heap_.size() - 1);
+        return true;
+    }
+
+    //Board is full, so the Player must outrank the current cutoff
+    if (!(player > heap_.front())) {
+        return false;
+    }
+    slot_.erase(heap_.front().id_);
+    heap_.front() = player;
+    slot_[player.id_] = 0;
+    siftDown(0);
+    return true;
+}
+
+/**
+ * @brief Returns whether a Player with the given id is on the board.
+ */
+bool IndexedTopK::contains(const size_t& id) const {
+    return slot_.find(id) != slot_.end();
+}
+
+/**
+ * @brief Returns the lowest leveled Player on the board (ie. the cutoff).
+ *
+ * @pre The board is non-empty.
+ */
+const Player& IndexedTopK::min() const {
+    return heap_.front();
+}
+
+/**
+ * @brief Returns the number of Players currently on the board.
+ */
+size_t IndexedTopK::size() const {
+    return heap_.size();
+}
+
+/**
+ * @brief Returns whether the board holds `capacity` Players.
+ */
+bool IndexedTopK::full() const {
+    return heap_.size() == capacity_;
+}
+
+/**
+ * @brief Returns a copy of the board's Players in sorted (least to greatest) order.
+ */
+std::vector<Player> IndexedTopK::sorted() const {
+    std::vector<Player> players(heap_);
+    std::sort(players.begin(), players.end());
+    return players;
+}
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Player.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+namespace Online {
+/**
+ * @brief A bounded min-heap of Players that keeps each `id_` at most once.
+ *
+ * Alongside the heap vector we keep an id -> heap slot index, so that a
+ * Player already on the board is found in O(1) and updated in place by
+ * percolating it to its new position in O(log k), rather than being pushed
+ * a second time (or forcing a rebuild of the whole heap).
+ *
+ * @example Suppose we have a capacity of 2 and offer, in order:
+ *   Player("RANNI", 10, 1), Player("RADAHN", 20, 2), Player("RANNI", 30, 1)
+ *
+ * Then the board holds { RADAHN(20), RANNI(30) } rather than
+ * { RANNI(30), RADAHN(20), RANNI(10) } trimmed to two entries.
+ */
+class IndexedTopK {
+private:
+    std::vector<Player> heap_; //Min-heap by level, root is the current cutoff
+    std::unordered_map<size_t, size_t> slot_; //Maps a Player id to its index in heap_
+    size_t capacity_; //The maximum number of distinct Players kept
+
+    /**
+     * @brief Swaps two heap slots, keeping the id -> slot index in sync.
+     */
+    void swapSlots(const size_t& a, const size_t& b);
+
+    /**
+     * @brief Percolates the Player at index i up/down to restore the min-heap.
+     */
+    void siftUp(size_t i);
+    void siftDown(size_t i);
+
+public:
+    /**
+     * @brief Constructs an empty board holding at most `capacity` distinct Players.
+     *
+     * @param capacity The number of distinct Players to keep (ie. the k in top-k)
+     */
+    IndexedTopK(const size_t& capacity);
+
+    /**
+     * @brief Bulk-loads a board from Players sorted in ascending order by level
+     *        (eg. a restored snapshot), in O(N) time & with sequential writes.
+     *
+     * An ascending array is already a valid min-heap, so no sifting is needed.
+     * Should an id appear more than once, only its last (ie. best) entry is kept;
+     * should there be more than `capacity` distinct ids, only the best are kept.
+     *
+     * @param capacity The number of distinct Players to keep (ie. the k in top-k)
+     * @param sorted The Players to load, sorted in ascending order by level
+     */
+    IndexedTopK(const size_t& capacity, const std::vector<Player>& sorted);
+
+    /**
+     * @brief Bulk-loads a board from Players in any order, sorting them
+     *        in parallel (see `Parallel::sort()`) before loading.
+     *
+     * @param capacity The number of distinct Players to keep (ie. the k in top-k)
+     * @param players The Players to load, in any order
+     * @param threads The number of threads to sort with (0 for the hardware concurrency)
+     * @return The loaded board
+     */
+    static IndexedTopK fromUnsorted(const size_t& capacity, std::vector<Player> players, unsigned threads = 0);
+
+    /**
+     * @brief Offers a Player to the board.
+     *
+     * - If the Player's id is already on the board, its entry is raised to
+     *   the new level when that level is higher (its best level is kept).
+     * - Otherwise, the Player is added while the board has room, or replaces
+     *   the current minimum if it outranks it.
+     *
+     * Performs in O(log k) time.
+     *
+     * @param player A reference to the Player to be offered
+     * @return true if the contents of the board changed, false otherwise
+     */
+    bool offer(const Player& player);
+
+    /**
+     * @brief Returns whether a Player with the given id is on the board.
+     */
+    bool contains(const size_t& id) const;
+
+    /**
+     * @brief Returns the lowest leveled Player on the board (ie. the cutoff).
+     *
+     * @pre The board is non-empty.
+     */
+    const Player& min() const;
+
+    /**
+     * @brief Returns the number of Players currently on the board.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns whether the board holds `capacity` Players.
+     */
+    bool full() const;
+
+    /**
+     * @brief Returns a copy of the board's Players in sorted (least to greatest) order.
+     */
+    std::vector<Player> sorted() const;
+};
+};
@@ -1,4 +1,9 @@
 #include "Leaderboard.hpp"
+#include "SortedTopK.hpp"
+#include "RadixTopK.hpp"
+#include "BucketTopK.hpp"
+
+#include <limits>
 
 /**
  * @brief Constructor for RankingResult with top players, cutoffs, and elapsed time.
@@ -97,6 +102,102 @@ RankingResult quickSelectRank(std::vector<Player>& players) {
     //Return the Ranking Result object
     return RankingResult(topPlayers, {}, elapsed);
 }
+
+/**
+ * @brief A version of `quickSelectRank()` that skips any Player whose id is excluded.
+ *
+ * @param players A reference to the vector of Player objects to be ranked
+ * @param excluded The ids which may not appear on the leaderboard
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top 10% of players from the input which are not excluded,
+ *                  in sorted order (ascending)
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+ *
+ * @post The order of the parameter vector is modified.
+ */
+RankingResult quickSelectRank(std::vector<Player>& players, const ExclusionFilter& excluded) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Calculate the number of leaderboard slots
+    size_t needed = players.size() / 10;
+    std::vector<Player> topPlayers;
+    topPlayers.reserve(needed);
+
+    //Select the top `needed` of the unselected range [begin, end), keep the eligible
+    //ones, & repeat for however many were excluded
+    std::vector<Player>::iterator end = players.end();
+    while (needed > 0 && end != players.begin()) {
+        size_t available = std::distance(players.begin(), end);
+        std::vector<Player>::iterator pivot = end - std::min(needed, available);
+        std::nth_element(players.begin(), pivot, end);
+
+        for (std::vector<Player>::iterator it = pivot; it != end; ++it) {
+            if (!excluded.contains(it->id_)) {
+                topPlayers.push_back(*it);
+                needed--;
+            }
+        }
+        end = pivot;
+    }
+
+    //Sort the top players in ascending order
+    std::sort(topPlayers.begin(), topPlayers.end());
+
+    //Stop timer and calculate elapsed_
+    auto stop = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(stop - start).count();
+
+    //Return the Ranking Result object
+    return RankingResult(topPlayers, {}, elapsed);
+}
+
+/**
+ * @brief A version of `heapRank()` that skips any Player whose id is excluded.
+ *
+ * @param players A reference to the vector of Player objects to be ranked
+ * @param excluded The ids which may not appear on the leaderboard
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top 10% of players from the input which are not excluded,
+ *                  in sorted order (ascending)
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+ *
+ * @post The order of the parameter vector is modified.
+ */
+RankingResult heapRank(std::vector<Player>& players, const ExclusionFilter& excluded) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Create a max-heap from players vector
+    std::make_heap(players.begin(), players.end());
+
+    //Calculate 10% of the total players
+    size_t topCount = players.size() / 10;
+
+    //Vector to store the top players
+    std::vector<Player> topPlayers;
+
+    //Extract the top players from players heap, checking only those popped
+    while (topPlayers.size() < topCount && !players.empty()) {
+        std::pop_heap(players.begin(), players.end());
+        if (!excluded.contains(players.back().id_)) {
+            topPlayers.push_back(players.back());
+        }
+        players.pop_back();
+    }
+
+    //Sort the top players in ascending order using std::sort from <algorithm>
+    std::sort(topPlayers.begin(), topPlayers.end());
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //Return a Ranking Result object
+    return RankingResult(topPlayers, {}, elapsed);
+}
 };
 namespace Online {
 /**
@@ -239,4 +340,443 @@ RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interva
     //Return the Ranking Result object
     return RankingResult(topPlayers, cutoffs, elapsed);
 }
+/**
+ * @brief A version of `rankIncoming()` that skips any Player whose id is excluded.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param excluded The ids which may not appear on the leaderboard
+ * @return A RankingResult as for `rankIncoming()`, restricted to Players which are
+ *         not excluded. Excluded Players still count towards the player count milestones.
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, const ExclusionFilter& excluded) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Creates a vector to store the top players and a map for cutoffs
+    std::vector<Player> topPlayers;
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t playerCount = 0;
+
+    //Process the stream until no players remain
+    while (stream.remaining() > 0) {
+        Player currentPlayer = stream.nextPlayer();
+        playerCount++;
+
+        if (topPlayers.size() < reporting_interval) {
+            if (!excluded.contains(currentPlayer.id_)) {
+                topPlayers.push_back(currentPlayer);
+                if (topPlayers.size() == reporting_interval) {
+                    std::make_heap(topPlayers.begin(), topPlayers.end(), std::greater<Player>());
+                }
+            }
+        } else if (currentPlayer > topPlayers.front() && !excluded.contains(currentPlayer.id_)) {
+            //Only survivors above the cutoff are ever checked for exclusion
+            replaceMin(topPlayers.begin(), topPlayers.end(), currentPlayer);
+        }
+
+        if (playerCount % reporting_interval == 0 && !topPlayers.empty()) {
+            cutoffs[playerCount] = topPlayers.size() < reporting_interval
+                ? std::min_element(topPlayers.begin(), topPlayers.end())->level_
+                : topPlayers.front().level_;
+        }
+    }
+
+    // Record cutoff for total players if not already recorded
+    if (!topPlayers.empty() && cutoffs.find(playerCount) == cutoffs.end()) {
+        cutoffs[playerCount] = topPlayers.size() < reporting_interval
+            ? std::min_element(topPlayers.begin(), topPlayers.end())->level_
+            : topPlayers.front().level_;
+    }
+
+    //Sort the top players in ascending order
+    std::sort(topPlayers.begin(), topPlayers.end());
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //Return the Ranking Result object
+    return RankingResult(topPlayers, cutoffs, elapsed);
+}
+
+/**
+ * @brief A deduplicating version of `rankIncoming()`, in which each Player `id_`
+ *        occupies at most one slot of the leaderboard (at its best level).
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @return A RankingResult in which:
+ * - top_       -> Contains the top <reporting_interval> distinct Players read in the
+ *                 stream, each at its best level, in sorted (least to greatest) order
+ * - cutoffs_   -> Maps player count milestones to minimum level required at that point,
+ *                 including the minimum level after ALL players have been read
+ * - elapsed_   -> Contains the duration (ms) of the selection/sorting operation
+ *                 excluding fetching the next player in the stream
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncomingUnique(PlayerStream& stream, const size_t& reporting_interval) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Creates an id-indexed heap for the top players and a map for cutoffs
+    IndexedTopK topPlayers(reporting_interval);
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t playerCount = 0;
+
+    //Process the stream until no players remain
+    while (stream.remaining() > 0) {
+        Player currentPlayer = stream.nextPlayer();
+        playerCount++;
+
+        //Repeated ids are raised in place rather than inserted twice
+        topPlayers.offer(currentPlayer);
+
+        if (playerCount % reporting_interval == 0) {
+            cutoffs[playerCount] = topPlayers.min().level_;
+        }
+    }
+
+    // Record cutoff for total players if not already recorded
+    if (topPlayers.size() > 0 && cutoffs.find(playerCount) == cutoffs.end()) {
+        cutoffs[playerCount] = topPlayers.min().level_;
+    }
+
+    //Sort the top players in ascending order
+    std::vector<Player> top = topPlayers.sorted();
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //Return the Ranking Result object
+    return RankingResult(top, cutoffs, elapsed);
+}
+/**
+ * @brief A version of `rankIncoming()` with bounded end-of-stream latency.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param tail_window The number of remaining players at which to start finalizing
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncomingBounded(PlayerStream& stream, const size_t& reporting_interval, const size_t& tail_window) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Creates a vector to store the top players and a map for cutoffs
+    std::vector<Player> topPlayers;
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t playerCount = 0;
+
+    //The background sort of the frozen heap, & the players accepted after freezing it
+    std::future<std::vector<Player>> frozen;
+    std::vector<Player> tailAccepted;
+
+    //Process the stream until no players remain
+    while (stream.remaining() > 0) {
+        //Freeze a full heap once the tail begins, & sort the copy in the background
+        if (!frozen.valid() && stream.remaining() <= tail_window && topPlayers.size() == reporting_interval) {
+            frozen = std::async(std::launch::async, [copy = topPlayers]() mutable {
+                std::sort(copy.begin(), copy.end());
+                return copy;
+            });
+        }
+
+        Player currentPlayer = stream.nextPlayer();
+        playerCount++;
+
+        if (topPlayers.size() < reporting_interval) {
+            topPlayers.push_back(currentPlayer);
+            if (topPlayers.size() == reporting_interval) {
+                std::make_heap(topPlayers.begin(), topPlayers.end(), std::greater<Player>());
+            }
+        } else if (currentPlayer > topPlayers.front()) {
+            if (frozen.valid()) {
+                tailAccepted.push_back(currentPlayer);
+            }
+            replaceMin(topPlayers.begin(), topPlayers.end(), currentPlayer);
+        }
+
+        if (playerCount % reporting_interval == 0) {
+            cutoffs[playerCount] = topPlayers.front().level_;
+        }
+    }
+
+    // Record cutoff for total players if not already recorded
+    if (cutoffs.find(playerCount) == cutoffs.end()) {
+        cutoffs[playerCount] = topPlayers.front().level_;
+    }
+
+    std::vector<Player> top;
+    if (!frozen.valid()) {
+        //No tail was frozen, so sort the top players as rankIncoming() does
+        std::sort(topPlayers.begin(), topPlayers.end());
+        top = std::move(topPlayers);
+    } else {
+        //Merge the largest <reporting_interval> of the sorted copy & the (few) tail acceptances
+        std::vector<Player> sorted = frozen.get();
+        std::sort(tailAccepted.begin(), tailAccepted.end());
+
+        top.resize(reporting_interval);
+        size_t i = sorted.size();
+        size_t j = tailAccepted.size();
+        for (size_t out = reporting_interval; out > 0; --out) {
+            if (j > 0 && (i == 0 || tailAccepted[j - 1] > sorted[i - 1])) {
+                top[out - 1] = std::move(tailAccepted[--j]);
+            } else {
+                top[out - 1] = std::move(sorted[--i]);
+            }
+        }
+    }
+
+    //Move (rather than copy) the results into the Ranking Result object
+    RankingResult result;
+    result.top_ = std::move(top);
+    result.cutoffs_ = std::move(cutoffs);
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    result.elapsed_ = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return result;
+}
+
+/**
+ * @brief A version of `rankIncoming()` which keeps the running leaderboard in the
+ *        container of the given strategy.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param strategy The container in which to keep the running leaderboard
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, const TopKStrategy& strategy) {
+    switch (strategy) {
+    case TopKStrategy::SortedTree:
+        return rankIncomingSorted(stream, reporting_interval);
+    case TopKStrategy::RadixHeap:
+        return rankIncomingRadix(stream, reporting_interval);
+    default:
+        return rankIncoming(stream, reporting_interval);
+    }
+}
+
+/**
+ * @brief A version of `rankIncoming()` for streams whose levels lie in a declared range,
+ *        using a bucket queue when the range is small.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param range The (inclusive) range in which every level in the stream lies
+ * @return A RankingResult as for `rankIncoming()`
+ * @throws std::out_of_range If the bucket queue is selected & a Player's level lies
+ *         outside the declared range
+ */
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, const LevelRange& range) {
+    if (range.hi_ >= range.lo_ && range.hi_ - range.lo_ < BucketTopK::MAX_RANGE) {
+        return rankIncomingBucketed(stream, reporting_interval, range);
+    }
+    return rankIncoming(stream, reporting_interval);
+}
+
+/**
+ * @brief A version of `rankIncoming()` which reads the stream in batches & inserts
+ *        each batch's survivors together, by `replaceMin()` or by selection,
+ *        whichever is cheaper for their number.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param batch_size The (maximum) number of Players read per batch
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncomingBatched(PlayerStream& stream, const size_t& reporting_interval, const size_t& batch_size) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Creates a vector to store the top players and a map for cutoffs
+    std::vector<Player> topPlayers;
+    topPlayers.reserve(reporting_interval + batch_size);
+    std::unordered_map<size_t, size_t> cutoffs;
+    std::vector<Player> survivors;
+    survivors.reserve(batch_size);
+    size_t playerCount = 0;
+
+    //The number of survivors above which selection beats one replaceMin() each
+    size_t logK = 1;
+    while ((size_t(1) << logK) < reporting_interval) {
+        logK++;
+    }
+
+    //Process the stream until no players remain
+    while (stream.remaining() > 0) {
+        //Cut the batch short at the next milestone
+        size_t toMilestone = reporting_interval - playerCount % reporting_interval;
+        size_t batch = std::min({ std::max<size_t>(batch_size, 1), toMilestone, stream.remaining() });
+
+        //Gather the survivors against the cutoff at the start of the batch
+        survivors.clear();
+        for (size_t i = 0; i < batch; ++i) {
+            Player currentPlayer = stream.nextPlayer();
+            if (topPlayers.size() < reporting_interval) {
+                topPlayers.push_back(currentPlayer);
+                if (topPlayers.size() == reporting_interval) {
+                    std::make_heap(topPlayers.begin(), topPlayers.end(), std::greater<Player>());
+                }
+            } else if (currentPlayer > topPlayers.front()) {
+                survivors.push_back(currentPlayer);
+            }
+        }
+        playerCount += batch;
+
+        if (survivors.size() * logK < reporting_interval + survivors.size()) {
+            for (Player& survivor : survivors) {
+                if (survivor > topPlayers.front()) {
+                    replaceMin(topPlayers.begin(), topPlayers.end(), survivor);
+                }
+            }
+        } else {
+            //Select the best k of heap + survivors in linear time, then re-heapify
+            topPlayers.insert(topPlayers.end(), survivors.begin(), survivors.end());
+            std::nth_element(topPlayers.begin(), topPlayers.end() - reporting_interval, topPlayers.end());
+            topPlayers.erase(topPlayers.begin(), topPlayers.end() - reporting_interval);
+            std::make_heap(topPlayers.begin(), topPlayers.end(), std::greater<Player>());
+        }
+
+        if (playerCount % reporting_interval == 0) {
+            cutoffs[playerCount] = topPlayers.front().level_;
+        }
+    }
+
+    // Record cutoff for total players if not already recorded
+    if (!topPlayers.empty() && cutoffs.find(playerCount) == cutoffs.end()) {
+        cutoffs[playerCount] = topPlayers.front().level_;
+    }
+
+    //Sort the top players in ascending order
+    std::sort(topPlayers.begin(), topPlayers.end());
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //Return the Ranking Result object
+    return RankingResult(topPlayers, cutoffs, elapsed);
+}
+
+/**
+ * @brief A version of `rankIncoming()` which also records, for every reporting interval,
+ *        a log-bucketed histogram of the levels read during it.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels & histograms
+ * @param histograms The series to which each interval's histogram is appended
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, LevelHistogramSeries& histograms) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Creates a vector to store the top players and a map for cutoffs
+    std::vector<Player> topPlayers;
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t playerCount = 0;
+
+    //Reserve a row per milestone up front, so the series is never copied as it grows
+    size_t intervals = reporting_interval == 0 ? 1 : stream.remaining() / reporting_interval + 1;
+    histograms.milestones_.reserve(histograms.milestones_.size() + intervals);
+    histograms.counts_.reserve(histograms.counts_.size() + intervals * LevelHistogram::BUCKETS);
+
+    //Interleaved sub-histograms for the current interval
+    uint32_t lanes[LevelHistogram::LANES][LevelHistogram::BUCKETS] = {};
+    auto flush = [&]() {
+        histograms.milestones_.push_back(playerCount);
+        size_t row = histograms.counts_.size();
+        histograms.counts_.resize(row + LevelHistogram::BUCKETS);
+        for (size_t b = 0; b < LevelHistogram::BUCKETS; ++b) {
+            uint32_t sum = 0;
+            for (size_t lane = 0; lane < LevelHistogram::LANES; ++lane) {
+                sum += lanes[lane][b];
+                lanes[lane][b] = 0;
+            }
+            histograms.counts_[row + b] = sum;
+        }
+    };
+
+    //Process the stream until no players remain
+    while (stream.remaining() > 0) {
+        Player currentPlayer = stream.nextPlayer();
+        lanes[playerCount % LevelHistogram::LANES][LevelHistogram::bucketOf(currentPlayer.level_)]++;
+        playerCount++;
+
+        if (topPlayers.size() < reporting_interval) {
+            topPlayers.push_back(currentPlayer);
+            if (topPlayers.size() == reporting_interval) {
+                std::make_heap(topPlayers.begin(), topPlayers.end(), std::greater<Player>());
+            }
+        } else if (currentPlayer > topPlayers.front()) {
+            replaceMin(topPlayers.begin(), topPlayers.end(), currentPlayer);
+        }
+
+        if (playerCount % reporting_interval == 0) {
+            cutoffs[playerCount] = topPlayers.front().level_;
+            flush();
+        }
+    }
+
+    // Record cutoff (& histogram) for total players if not already recorded
+    if (cutoffs.find(playerCount) == cutoffs.end()) {
+        cutoffs[playerCount] = topPlayers.front().level_;
+        flush();
+    }
+
+    //Sort the top players in ascending order
+    std::sort(topPlayers.begin(), topPlayers.end());
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //Return the Ranking Result object
+    return RankingResult(topPlayers, cutoffs, elapsed);
+}
+
+/**
+ * @brief Measures the overhead of recording the histogram series: `rankIncoming()` with
+ *        & without a `LevelHistogramSeries`, over the same Players.
+ *
+ * Each variant is run <repeats> times, alternating, & its fastest run is kept, so that
+ * noise from the rest of the machine does not read as overhead.
+ *
+ * @param players The Players to be ranked, in stream order
+ * @param reporting_interval The frequency at which to record cutoff levels & histograms
+ * @param repeats The number of runs of each variant
+ * @return The measured HistogramStats
+ */
+HistogramStats measureHistograms(const std::vector<Player>& players, const size_t& reporting_interval, const size_t& repeats) {
+    HistogramStats stats { std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), 0 };
+
+    for (size_t r = 0; r < std::max<size_t>(repeats, 1); ++r) {
+        VectorPlayerStream plainStream(players);
+        stats.plainElapsed_ = std::min(stats.plainElapsed_, rankIncoming(plainStream, reporting_interval).elapsed_);
+
+        VectorPlayerStream histogramStream(players);
+        LevelHistogramSeries histograms;
+        stats.histogramElapsed_ = std::min(stats.histogramElapsed_, rankIncoming(histogramStream, reporting_interval, histograms).elapsed_);
+    }
+
+    stats.overhead_ = (stats.histogramElapsed_ - stats.plainElapsed_) / stats.plainElapsed_ * 100;
+    return stats;
+}
 };
\ No newline at end of file
@@ -2,12 +2,16 @@
 
 #include "Player.hpp"
 #include "PlayerStream.hpp"
+#include "IndexedTopK.hpp"
+#include "ExclusionFilter.hpp"
+#include "LevelHistogram.hpp"
 
 #include <iterator>
 #include <unordered_map>
 #include <vector>
 #include <chrono>
 #include <algorithm>
+#include <future>
 
 struct RankingResult {
     /**
@@ -86,6 +90,44 @@ RankingResult quickSelectRank(std::vector<Player>& players);
  * @post The order of the parameter vector is modified.
  */
 RankingResult heapRank(std::vector<Player>& players);
+
+/**
+ * @brief A version of `quickSelectRank()` that skips any Player whose id is excluded.
+ *
+ * The leaderboard still holds 10% of `players.size()` slots; excluded Players
+ * simply never occupy one. Only Players selected into the top segment are checked
+ * against `excluded`; should any be excluded, the shortfall is selected again
+ * from the (already partitioned) remainder.
+ *
+ * @param players A reference to the vector of Player objects to be ranked
+ * @param excluded The ids which may not appear on the leaderboard
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top 10% of players from the input which are not excluded,
+ *                  in sorted order (ascending)
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+ *
+ * @post The order of the parameter vector is modified.
+ */
+RankingResult quickSelectRank(std::vector<Player>& players, const ExclusionFilter& excluded);
+
+/**
+ * @brief A version of `heapRank()` that skips any Player whose id is excluded.
+ *
+ * Only the Players popped off the heap are checked against `excluded`, so the
+ * bulk of the input (below the cutoff) is never checked at all.
+ *
+ * @param players A reference to the vector of Player objects to be ranked
+ * @param excluded The ids which may not appear on the leaderboard
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top 10% of players from the input which are not excluded,
+ *                  in sorted order (ascending)
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the selection/sorting operation
+ *
+ * @post The order of the parameter vector is modified.
+ */
+RankingResult heapRank(std::vector<Player>& players, const ExclusionFilter& excluded);
 };
 
 namespace Online {
@@ -150,4 +192,175 @@ void replaceMin(PlayerIt first, PlayerIt last, Player& target);
  * elapsed_ = 0.003 (Your runtime will vary based on hardware)
  */
 RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval);
+
+/**
+ * @brief A version of `rankIncoming()` that skips any Player whose id is excluded.
+ *
+ * Once the heap is full, a Player is only checked against `excluded` after it has
+ * beaten the current cutoff, so below-cutoff Players cost nothing extra.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param excluded The ids which may not appear on the leaderboard
+ * @return A RankingResult as for `rankIncoming()`, restricted to Players which are
+ *         not excluded. Excluded Players still count towards the player count milestones.
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, const ExclusionFilter& excluded);
+/**
+ * @brief A deduplicating version of `rankIncoming()`, in which each Player `id_`
+ *        occupies at most one slot of the leaderboard (at its best level).
+ *
+ * A Player seen again is updated in place within the heap via an id -> heap slot
+ * index (see `IndexedTopK`) in O(log k), so the leaderboard never holds two
+ * entries for one account and never has to be post-filtered below k entries.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @return A RankingResult in which:
+ * - top_       -> Contains the top <reporting_interval> distinct Players read in the
+ *                 stream, each at its best level, in sorted (least to greatest) order
+ *                 (fewer if the stream holds fewer distinct ids)
+ * - cutoffs_   -> Maps player count milestones to minimum level required at that point,
+ *                 including the minimum level after ALL players have been read
+ * - elapsed_   -> Contains the duration (ms) of the selection/sorting operation
+ *                 excluding fetching the next player in the stream
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncomingUnique(PlayerStream& stream, const size_t& reporting_interval);
+/**
+ * @brief A version of `rankIncoming()` with bounded end-of-stream latency.
+ *
+ * Once only <tail_window> players remain in the stream, the (full) heap is copied
+ * & the copy is sorted on a background thread while ingestion continues. Players
+ * accepted during the tail are noted as they replace the minimum. As every one of
+ * them evicts the current minimum, the final leaderboard is the top <reporting_interval>
+ * of (sorted copy + tail acceptances), which is published by a linear merge rather
+ * than an O(k log k) sort, & moved (rather than copied) into the RankingResult.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param tail_window The number of remaining players at which to start finalizing.
+ *        Larger windows give the background sort more time, but more tail acceptances
+ *        to merge. A window of 0 (or a stream too short to fill the heap first) falls
+ *        back to sorting at the end, as `rankIncoming()` does.
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncomingBounded(PlayerStream& stream, const size_t& reporting_interval, const size_t& tail_window);
+
+/**
+ * @brief The container in which an online ranking keeps its running leaderboard.
+ */
+enum class TopKStrategy {
+    BinaryHeap, //A vector heap maintained with `replaceMin()` (see `rankIncoming()`)
+    SortedTree, //A `SortedTopK`, which is always in sorted order (see `rankIncomingSorted()`)
+    RadixHeap //A `RadixTopK`, exploiting the monotone cutoff (see `rankIncomingRadix()`)
+};
+
+/**
+ * @brief A version of `rankIncoming()` which keeps the running leaderboard in the
+ *        container of the given strategy. Every strategy yields the same leaderboard.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param strategy The container in which to keep the running leaderboard
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, const TopKStrategy& strategy);
+
+/**
+ * @brief A declared, inclusive range of Player levels (eg. 1-5000), within which
+ *        every level of a stream is promised to lie.
+ */
+struct LevelRange {
+    size_t lo_; //The lowest possible level
+    size_t hi_; //The highest possible level
+};
+
+/**
+ * @brief A version of `rankIncoming()` for streams whose levels lie in a declared range.
+ *
+ * When the range is small (at most `BucketTopK::MAX_RANGE` levels), the running
+ * leaderboard is kept in a bucket queue (see `rankIncomingBucketed()`), with O(1)
+ * insertion & eviction, an O(1) cutoff & no final sort. Otherwise this is `rankIncoming()`.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param range The (inclusive) range in which every level in the stream lies
+ * @return A RankingResult as for `rankIncoming()`
+ * @throws std::out_of_range If the bucket queue is selected & a Player's level lies
+ *         outside the declared range
+ *
+ * @post All elements of the stream are read until there are none remaining
+ *       (unless an exception is thrown).
+ */
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, const LevelRange& range);
+
+/**
+ * @brief A version of `rankIncoming()` which reads the stream in batches & inserts
+ *        each batch's survivors (ie. Players above the cutoff) together.
+ *
+ * For each batch (cut short at every reporting milestone, so the cutoffs recorded
+ * are exact), the survivors are gathered against the cutoff at the start of the batch.
+ * Then, whichever is cheaper for their count s:
+ * - Few survivors (s log k < k + s): each is inserted with `replaceMin()`, in O(s log k).
+ * - Many survivors (eg. at the start of the stream, or during a level-up event): they
+ *   are appended to the heap, the best k are selected with `std::nth_element()` &
+ *   the heap is rebuilt with `std::make_heap()`, in O(k + s).
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param batch_size The (maximum) number of Players read per batch
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncomingBatched(PlayerStream& stream, const size_t& reporting_interval, const size_t& batch_size = 4096);
+
+/**
+ * @brief A version of `rankIncoming()` which also records, for every reporting interval,
+ *        a log-bucketed histogram of the levels read during it (see `LevelHistogram`).
+ *
+ * Each Player's bucket is counted into one of LANES interleaved sub-histograms (by
+ * player count), so consecutive increments of one bucket do not depend on each other.
+ * The lanes are summed into the series at each milestone.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels & histograms
+ * @param histograms The series to which each interval's histogram is appended; its
+ *        milestones match the keys of the returned cutoffs_ (including the final count)
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, LevelHistogramSeries& histograms);
+
+/**
+ * @brief Measurements of the histogram series' overhead on `rankIncoming()`.
+ */
+struct HistogramStats {
+    double plainElapsed_; //Fastest duration (ms) of rankIncoming() alone
+    double histogramElapsed_; //Fastest duration (ms) of rankIncoming() recording the series
+    double overhead_; //The relative overhead of the series (%)
+};
+
+/**
+ * @brief Measures the overhead of recording the histogram series: `rankIncoming()` with
+ *        & without a `LevelHistogramSeries`, over the same Players.
+ *
+ * Each variant is run <repeats> times, alternating, & its fastest run is kept, so that
+ * noise from the rest of the machine does not read as overhead.
+ *
+ * @param players The Players to be ranked, in stream order
+ * @param reporting_interval The frequency at which to record cutoff levels & histograms
+ * @param repeats The number of runs of each variant
+ * @return The measured HistogramStats
+ */
+HistogramStats measureHistograms(const std::vector<Player>& players, const size_t& reporting_interval, const size_t& repeats = 5);
 };
\ No newline at end of file
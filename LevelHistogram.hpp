@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LevelHistogram {
+constexpr size_t SUB_BUCKETS = 4; //The buckets per power of two (ie. ~19% relative width)
+constexpr size_t BUCKETS = 256; //Enough for every 64-bit level (248 are used)
+constexpr size_t LANES = 4; //The interleaved sub-histograms counted into
+
+/**
+ * @brief Returns the log-scale bucket of a level: offset by SUB_BUCKETS (so that levels
+ *        0-3 get buckets of their own), each power of two [2^e, 2^(e+1)) is split into
+ *        SUB_BUCKETS equal buckets. Branch-free: a count of leading zeros & two shifts.
+ *
+ * @pre level < 2^64 - SUB_BUCKETS
+ *
+ * @example Levels 0, 1, 2 & 3 fall into buckets 0-3; levels 4-5 into bucket 4;
+ * levels 1020-1275 into bucket 32.
+ */
+inline size_t bucketOf(const size_t& level) {
+    size_t offset = level + SUB_BUCKETS;
+    size_t e = 63 - __builtin_clzll(offset);
+    return SUB_BUCKETS * (e - 2) + ((offset >> (e - 2)) & (SUB_BUCKETS - 1));
+}
+
+/**
+ * @brief Returns the lowest level which falls into a bucket.
+ */
+inline size_t lowerBound(const size_t& bucket) {
+    size_t e = bucket / SUB_BUCKETS + 2;
+    return ((SUB_BUCKETS + bucket % SUB_BUCKETS) << (e - 2)) - SUB_BUCKETS;
+}
+};
+
+/**
+ * @brief A dense series of per-interval level histograms, recorded alongside the cutoffs
+ *        of `rankIncoming()`: for each reporting milestone, the number of Players read
+ *        since the previous milestone in each `LevelHistogram` bucket.
+ *
+ * Histograms are stored back to back (BUCKETS 32-bit counts each, ie. 1 KiB), so the
+ * whole series is one allocation & a histogram is a contiguous row.
+ */
+struct LevelHistogramSeries {
+    std::vector<size_t> milestones_; //The player count at the end of each interval
+    std::vector<uint32_t> counts_; //BUCKETS counts per interval, one interval after another
+
+    /**
+     * @brief Returns the histogram of the i-th interval (BUCKETS counts).
+     */
+    const uint32_t* at(const size_t& i) const {
+        return counts_.data() + i * LevelHistogram::BUCKETS;
+    }
+
+    /**
+     * @brief Returns the number of intervals recorded.
+     */
+    size_t size() const {
+        return milestones_.size();
+    }
+};
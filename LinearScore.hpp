@@ -0,0 +1,297 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A set of N attribute columns (eg. level, wins & playtime), each an array of
+ *        doubles, such that columns_[j][i] is attribute j of the i-th row.
+ *
+ * For `Offline::scoreRank()` row i is players[i]; for `Online::rankIncomingScored()`
+ * row i is the Player whose `id_` is i.
+ */
+template <size_t N>
+struct Columns {
+    std::array<const double*, N> columns_; //The attribute arrays
+    size_t rows_; //The length of every attribute array
+};
+
+/**
+ * @brief A ranking score which is a weighted sum of N attributes:
+ *        score(i) = bias_ + weights_[0] * columns_[0][i] + ... + weights_[N - 1] * columns_[N - 1][i]
+ *
+ * As N is a template parameter, `evaluate()` unrolls over the attributes & runs a
+ * plain loop over rows per block, which the compiler vectorizes (SIMD) at -O2/-O3.
+ */
+template <size_t N>
+struct LinearScore {
+    std::array<double, N> weights_; //The weight of each attribute
+    double bias_; //A constant added to every score
+
+    /**
+     * @brief Scores the rows [begin, begin + count) of a set of columns.
+     *
+     * @param columns The attribute columns
+     * @param begin The first row to score
+     * @param count The number of rows to score
+     * @param out The array into which to write the `count` scores
+     */
+    void evaluate(const Columns<N>& columns, const size_t& begin, const size_t& count, double* out) const {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = bias_;
+        }
+        for (size_t j = 0; j < N; ++j) {
+            const double* column = columns.columns_[j] + begin;
+            double weight = weights_[j];
+            for (size_t i = 0; i < count; ++i) {
+                out[i] += weight * column[i];
+            }
+        }
+    }
+
+    /**
+     * @brief Scores the rows given by an array of indices (ie. a gather), as for a block
+     *        of streamed Players identified by their ids.
+     *
+     * @param columns The attribute columns
+     * @param rows The rows to score
+     * @param count The number of rows to score
+     * @param out The array into which to write the `count` scores
+     */
+    void evaluate(const Columns<N>& columns, const size_t* rows, const size_t& count, double* out) const {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = bias_;
+        }
+        for (size_t j = 0; j < N; ++j) {
+            const double* column = columns.columns_[j];
+            double weight = weights_[j];
+            for (size_t i = 0; i < count; ++i) {
+                out[i] += weight * column[rows[i]];
+            }
+        }
+    }
+};
+
+/**
+ * @brief A result of ranking Players by a derived score rather than by level.
+ */
+struct ScoredResult {
+    std::vector<Player> top_; //The top Players in sorted (least to greatest) order by score
+    std::vector<double> scores_; //The score of each Player of top_
+    std::unordered_map<size_t, double> cutoffs_; //As for RankingResult, but of scores (online only)
+    double elapsed_; //Duration (ms) of the scoring & selection/sorting
+};
+
+namespace Scoring {
+constexpr size_t BLOCK = 256; //The number of rows scored at once (so the scores stay in L1)
+constexpr size_t SAMPLE = 4096; //The number of rows sampled to estimate an offline threshold
+
+/**
+ * @brief A row & its score, ordered by score for selection.
+ */
+struct Scored {
+    double score_;
+    size_t row_;
+
+    bool operator<(const Scored& other) const {
+        return score_ < other.score_;
+    }
+
+    bool operator>(const Scored& other) const {
+        return score_ > other.score_;
+    }
+};
+};
+
+namespace Offline {
+/**
+ * @brief Selects & sorts the top 10% of players by a linear score over their attribute
+ *        columns, scoring in blocks inside the selection loop (so no scored copy of the
+ *        players is ever materialized).
+ *
+ * - A strided sample of SAMPLE rows is scored to estimate a threshold a little below
+ *   the 90th percentile score.
+ * - Each block of BLOCK rows is scored with `LinearScore::evaluate()` into a small
+ *   buffer, & only rows at or above the threshold are kept as (score, row) candidates
+ *   (roughly 10% of the rows, plus a margin).
+ * - The top 10% are selected from the candidates with `std::nth_element()` & sorted.
+ *   Should the sample have overestimated the threshold (ie. too few candidates), the
+ *   pass is repeated keeping every row.
+ *
+ * @param players The Players to be ranked
+ * @param columns The attribute columns, where row i belongs to players[i]
+ * @param score The score to rank by
+ * @return A ScoredResult whose
+ * - top_ vector -> Contains the top 10% of players by score in sorted order (ascending)
+ * - scores_     -> Contains the score of each of them
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the scoring & selection/sorting
+ *
+ * @throws std::invalid_argument If the columns hold fewer rows than there are players
+ */
+template <size_t N>
+ScoredResult scoreRank(const std::vector<Player>& players, const Columns<N>& columns, const LinearScore<N>& score) {
+    if (columns.rows_ < players.size()) {
+        throw std::invalid_argument("Attribute columns hold fewer rows than there are players");
+    }
+
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    size_t n = players.size();
+    size_t k = n / 10;
+    ScoredResult result { {}, {}, {}, 0 };
+    if (k == 0) {
+        return result;
+    }
+
+    //Estimate the threshold from a strided sample, aiming for ~12% of rows as candidates
+    size_t samples = std::min(n, Scoring::SAMPLE);
+    std::vector<size_t> sampleRows(samples);
+    std::vector<double> sampleScores(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        sampleRows[i] = i * (n / samples);
+    }
+    score.evaluate(columns, sampleRows.data(), samples, sampleScores.data());
+    size_t rank = std::min(samples - 1, samples * 88 / 100);
+    std::nth_element(sampleScores.begin(), sampleScores.begin() + rank, sampleScores.end());
+    double threshold = sampleScores[rank];
+
+    std::vector<Scoring::Scored> candidates;
+    double scores[Scoring::BLOCK];
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        candidates.clear();
+        candidates.reserve(n / 8);
+        for (size_t begin = 0; begin < n; begin += Scoring::BLOCK) {
+            size_t count = std::min(Scoring::BLOCK, n - begin);
+            score.evaluate(columns, begin, count, scores);
+            for (size_t i = 0; i < count; ++i) {
+                if (attempt == 1 || scores[i] >= threshold) {
+                    candidates.push_back(Scoring::Scored { scores[i], begin + i });
+                }
+            }
+        }
+        if (candidates.size() >= k) {
+            break;
+        }
+    }
+
+    //Select & sort the top k candidates in ascending order of score
+    std::nth_element(candidates.begin(), candidates.end() - k, candidates.end(), std::less<Scoring::Scored>());
+    std::sort(candidates.end() - k, candidates.end(), std::less<Scoring::Scored>());
+
+    result.top_.reserve(k);
+    result.scores_.reserve(k);
+    for (auto it = candidates.end() - k; it != candidates.end(); ++it) {
+        result.top_.push_back(players[it->row_]);
+        result.scores_.push_back(it->score_);
+    }
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    result.elapsed_ = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return result;
+}
+};
+
+namespace Online {
+/**
+ * @brief A version of `rankIncoming()` which ranks by a linear score over attribute
+ *        columns (looked up by Player `id_`) rather than by level.
+ *
+ * The stream is read in blocks of up to BLOCK Players (cut short at every reporting
+ * milestone); each block's attributes are gathered & scored at once, then offered
+ * to a bounded min-heap of scores.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff scores
+ * @param columns The attribute columns, where row i belongs to the Player with `id_` i
+ * @param score The score to rank by
+ * @return A ScoredResult in which:
+ * - top_       -> Contains the top <reporting_interval> Players by score, in sorted
+ *                 (least to greatest) order
+ * - scores_    -> Contains the score of each of them
+ * - cutoffs_   -> Maps player count milestones to the minimum score required at that point,
+ *                 including after ALL players have been read
+ * - elapsed_   -> Contains the duration (ms) of the scoring & selection/sorting
+ *
+ * @throws std::out_of_range If a Player's id has no row in the columns
+ * @post All elements of the stream are read until there are none remaining
+ *       (unless an exception is thrown).
+ */
+template <size_t N>
+ScoredResult rankIncomingScored(PlayerStream& stream, const size_t& reporting_interval, const Columns<N>& columns, const LinearScore<N>& score) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //The heap holds indices into `held`, which keeps each kept Player
+    std::vector<Scoring::Scored> heap;
+    std::vector<Player> held;
+    std::vector<Player> block;
+    size_t rows[Scoring::BLOCK];
+    double scores[Scoring::BLOCK];
+    ScoredResult result { {}, {}, {}, 0 };
+    size_t playerCount = 0;
+
+    while (stream.remaining() > 0) {
+        //Cut the block short at the next milestone
+        size_t toMilestone = reporting_interval - playerCount % reporting_interval;
+        size_t count = std::min({ Scoring::BLOCK, toMilestone, stream.remaining() });
+
+        block.clear();
+        for (size_t i = 0; i < count; ++i) {
+            block.push_back(stream.nextPlayer());
+            rows[i] = block.back().id_;
+            if (rows[i] >= columns.rows_) {
+                throw std::out_of_range("Player id " + std::to_string(rows[i]) + " has no row in the attribute columns");
+            }
+        }
+        playerCount += count;
+
+        score.evaluate(columns, rows, count, scores);
+        for (size_t i = 0; i < count; ++i) {
+            if (heap.size() < reporting_interval) {
+                heap.push_back(Scoring::Scored { scores[i], held.size() });
+                held.push_back(block[i]);
+                std::push_heap(heap.begin(), heap.end(), std::greater<Scoring::Scored>());
+            } else if (scores[i] > heap.front().score_) {
+                //Reuse the evicted Player's slot in `held`
+                std::pop_heap(heap.begin(), heap.end(), std::greater<Scoring::Scored>());
+                heap.back().score_ = scores[i];
+                held[heap.back().row_] = block[i];
+                std::push_heap(heap.begin(), heap.end(), std::greater<Scoring::Scored>());
+            }
+        }
+
+        if (playerCount % reporting_interval == 0) {
+            result.cutoffs_[playerCount] = heap.front().score_;
+        }
+    }
+
+    // Record cutoff for total players if not already recorded
+    if (!heap.empty() && result.cutoffs_.find(playerCount) == result.cutoffs_.end()) {
+        result.cutoffs_[playerCount] = heap.front().score_;
+    }
+
+    //Sort the heap in ascending order of score, then copy out the Players
+    std::sort_heap(heap.begin(), heap.end(), std::greater<Scoring::Scored>());
+    result.top_.reserve(heap.size());
+    result.scores_.reserve(heap.size());
+    for (auto it = heap.rbegin(); it != heap.rend(); ++it) {
+        result.top_.push_back(held[it->row_]);
+        result.scores_.push_back(it->score_);
+    }
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    result.elapsed_ = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return result;
+}
+};
@@ -0,0 +1,230 @@
+#include "NameIndex.hpp"
+#include "Hash.hpp"
+#include "Parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace {
+const double GAMMA = 2.0; //Bits per key at each level; trades space for fewer levels
+const size_t MAX_LEVELS = 24; //Keys still colliding after this many levels go to a small map
+
+/**
+ * @brief Hashes an interned key for the given cascade level.
+ */
+uint64_t levelHash(const uint64_t& key, const size_t& level) {
+    return Hash::mix64(key ^ (0x9e3779b97f4a7c15ULL * (level + 1)));
+}
+
+/**
+ * @brief Counts the set bits of a 64-bit word.
+ */
+size_t popcount(uint64_t word) {
+    return static_cast<size_t>(__builtin_popcountll(word));
+}
+};
+
+/**
+ * @brief Hashes a name to its interned 64-bit key.
+ */
+uint64_t NameIndex::key(const std::string& name) {
+    return Hash::bytes(name.data(), name.size());
+}
+
+/**
+ * @brief Builds the index over a snapshot of Players.
+ *
+ * @param players The snapshot to index
+ * @param threads The number of worker threads to build with
+ */
+NameIndex::NameIndex(const std::vector<Player>& players, unsigned threads)
+    : players_ { players }
+    , distinct_ { 0 }
+{
+    if (threads == 0) {
+        threads = Parallel::defaultThreads();
+    }
+    size_t n = players.size();
+
+    //Intern every name as a 64-bit key
+    std::vector<uint64_t> keys(n);
+    Parallel::forChunks(n, threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            keys[i] = key(players[i].name_);
+        }
+    });
+
+    //Deduplicate the keys
+    std::vector<uint64_t> distinct(keys);
+    Parallel::sort(distinct.begin(), distinct.end(), std::less<uint64_t>(), threads);
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    distinct_ = distinct.size();
+
+    buildCascade(std::move(distinct), threads);
+
+    //Group the record positions by slot (a counting sort, which keeps snapshot order)
+    std::vector<size_t> slots(n);
+    Parallel::forChunks(n, threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            slots[i] = slot(keys[i]);
+        }
+    });
+
+    offsets_.assign(distinct_ + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        offsets_[slots[i] + 1]++;
+    }
+    for (size_t s = 0; s < distinct_; ++s) {
+        offsets_[s + 1] += offsets_[s];
+    }
+
+    records_.resize(n);
+    std::vector<size_t> next(offsets_.begin(), offsets_.end() - 1);
+    for (size_t i = 0; i < n; ++i) {
+        records_[next[slots[i]]++] = i;
+    }
+}
+
+/**
+ * @brief Builds the perfect hash cascade over the given distinct keys.
+ *
+ * At each level, every remaining key is hashed into a bit array of
+ * GAMMA * (remaining keys) bits. Keys landing on a bit alone keep that bit;
+ * keys which collide are retried at the next level. A key's slot is then the
+ * number of kept bits preceding its own across all levels.
+ */
+void NameIndex::buildCascade(std::vector<uint64_t> keys, unsigned threads) {
+    levelOffsets_.push_back(0);
+
+    for (size_t level = 0; level < MAX_LEVELS && !keys.empty(); ++level) {
+        size_t words = std::max<size_t>(1, static_cast<size_t>(GAMMA * keys.size() + 63) / 64);
+        size_t width = words * 64;
+        std::unique_ptr<std::atomic<uint64_t>[]> seen(new std::atomic<uint64_t>[words]);
+        std::unique_ptr<std::atomic<uint64_t>[]> collided(new std::atomic<uint64_t>[words]);
+        for (size_t w = 0; w < words; ++w) {
+            seen[w].store(0, std::memory_order_relaxed);
+            collided[w].store(0, std::memory_order_relaxed);
+        }
+
+        //Mark each key's bit, noting any bit hit more than once
+        Parallel::forChunks(keys.size(), threads, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                size_t pos = levelHash(keys[i], level) % width;
+                uint64_t mask = 1ULL << (pos % 64);
+                if (seen[pos / 64].fetch_or(mask, std::memory_order_relaxed) & mask) {
+                    collided[pos / 64].fetch_or(mask, std::memory_order_relaxed);
+                }
+            }
+        });
+
+        //Keep only the bits hit exactly once
+        size_t base = bits_.size();
+        bits_.resize(base + words);
+        for (size_t w = 0; w < words; ++w) {
+            bits_[base + w] = seen[w].load(std::memory_order_relaxed) & ~collided[w].load(std::memory_order_relaxed);
+        }
+
+        //Collect the keys which collided for the next level
+        std::vector<std::vector<uint64_t>> retry(threads);
+        Parallel::forChunks(keys.size(), threads, [&](size_t begin, size_t end, unsigned t) {
+            for (size_t i = begin; i < end; ++i) {
+                size_t pos = levelHash(keys[i], level) % width;
+                if (collided[pos / 64].load(std::memory_order_relaxed) & (1ULL << (pos % 64))) {
+                    retry[t].push_back(keys[i]);
+                }
+            }
+        });
+
+        keys.clear();
+        for (const std::vector<uint64_t>& part : retry) {
+            keys.insert(keys.end(), part.begin(), part.end());
+        }
+        levelOffsets_.push_back(bits_.size() * 64);
+    }
+
+    //Rank directory: set bits preceding every block of 8 words
+    ranks_.assign(bits_.size() / 8 + 1, 0);
+    size_t total = 0;
+    for (size_t w = 0; w < bits_.size(); ++w) {
+        if (w % 8 == 0) {
+            ranks_[w / 8] = total;
+        }
+        total += popcount(bits_[w]);
+    }
+
+    //Any keys left over take the final slots
+    for (const uint64_t& leftover : keys) {
+        fallback_[leftover] = total++;
+    }
+}
+
+/**
+ * @brief Returns the slot of an interned key, or `distinct_` if the key
+ *        does not map to any slot.
+ */
+size_t NameIndex::slot(const uint64_t& key) const {
+    for (size_t level = 0; level + 1 < levelOffsets_.size(); ++level) {
+        size_t width = levelOffsets_[level + 1] - levelOffsets_[level];
+        size_t pos = levelOffsets_[level] + levelHash(key, level) % width;
+        uint64_t word = bits_[pos / 64];
+
+        if (word & (1ULL << (pos % 64))) {
+            //Rank = block count + whole words in the block + bits below pos in its word
+            size_t rank = ranks_[pos / 512];
+            for (size_t w = (pos / 512) * 8; w < pos / 64; ++w) {
+                rank += popcount(bits_[w]);
+            }
+            return rank + popcount(word & ((1ULL << (pos % 64)) - 1));
+        }
+    }
+
+    auto found = fallback_.find(key);
+    return found == fallback_.end() ? distinct_ : found->second;
+}
+
+/**
+ * @brief Returns the position of the first record with the given name,
+ *        or `npos` if there is none.
+ */
+size_t NameIndex::find(const std::string& name) const {
+    size_t s = slot(key(name));
+    if (s >= distinct_) {
+        return npos;
+    }
+
+    //Names outside the snapshot still map to some slot, so confirm against the record
+    for (size_t i = offsets_[s]; i < offsets_[s + 1]; ++i) {
+        if (players_[records_[i]].name_ == name) {
+            return records_[i];
+        }
+    }
+    return npos;
+}
+
+/**
+ * @brief Returns the positions of every record with the given name,
+ *        in snapshot order.
+ */
+std::vector<size_t> NameIndex::findAll(const std::string& name) const {
+    std::vector<size_t> matches;
+    size_t s = slot(key(name));
+    if (s >= distinct_) {
+        return matches;
+    }
+
+    for (size_t i = offsets_[s]; i < offsets_[s + 1]; ++i) {
+        if (players_[records_[i]].name_ == name) {
+            matches.push_back(records_[i]);
+        }
+    }
+    return matches;
+}
+
+/**
+ * @brief Returns the number of distinct names in the snapshot.
+ */
+size_t NameIndex::distinct() const {
+    return distinct_;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Player.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A static index from `Player::name_` to the positions of the matching
+ *        records in a snapshot vector, built once at snapshot load time.
+ *
+ * Names are interned as 64-bit hashes, over which a minimal perfect hash
+ * (BBHash-style: a cascade of collision-free bit arrays, ~3.5 bits per name) maps
+ * every distinct name to a unique slot in [0, distinct names). Each slot owns a
+ * contiguous run of record positions, so a lookup costs a probe of the first
+ * bit array (a second level is only needed for ~40% of names), a rank lookup,
+ * & a read of the matching record to confirm the name.
+ *
+ * Every build pass (hashing, sorting, each level of the cascade) is split
+ * across worker threads.
+ *
+ * @note The index borrows the snapshot vector: it must outlive the index,
+ *       & must not be modified while the index is in use.
+ *
+ * @example Given a snapshot v = {
+ *      Player("Rykard", 23),
+ *      Player("Malenia", 99),
+ *      Player("Rykard", 41)
+ *  }
+ *
+ * NameIndex index(v);
+ * index.find("Malenia")    -> 1
+ * index.findAll("Rykard")  -> { 0, 2 }
+ * index.find("Godrick")    -> NameIndex::npos
+ */
+class NameIndex {
+private:
+    const std::vector<Player>& players_; //The snapshot being indexed
+    std::vector<uint64_t> bits_; //The concatenated bit arrays of every level
+    std::vector<uint64_t> ranks_; //The number of set bits preceding each block of 8 words
+    std::vector<size_t> levelOffsets_; //The bit offset at which each level begins (plus the end)
+    std::unordered_map<uint64_t, size_t> fallback_; //Slots of the few names left after the last level
+    std::vector<size_t> offsets_; //offsets_[slot] .. offsets_[slot + 1] is the run of records of a slot
+    std::vector<size_t> records_; //Record positions, grouped by slot
+    size_t distinct_; //The number of distinct (interned) names
+
+    /**
+     * @brief Hashes a name to its interned 64-bit key.
+     */
+    static uint64_t key(const std::string& name);
+
+    /**
+     * @brief Builds the perfect hash cascade over the given distinct keys.
+     */
+    void buildCascade(std::vector<uint64_t> keys, unsigned threads);
+
+    /**
+     * @brief Returns the slot of an interned key, or `distinct_` if the key
+     *        does not map to any slot.
+     */
+    size_t slot(const uint64_t& key) const;
+
+public:
+    /**
+     * @brief The value returned by `find()` when no record has the given name.
+     */
+    static const size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @brief Builds the index over a snapshot of Players.
+     *
+     * Performs in expected O(N log N / threads + N) time, dominated by
+     * deduplicating the interned names.
+     *
+     * @param players The snapshot to index
+     * @param threads The number of worker threads to build with
+     */
+    NameIndex(const std::vector<Player>& players, unsigned threads = 0);
+
+    /**
+     * @brief Returns the position of the first record with the given name,
+     *        or `npos` if there is none.
+     */
+    size_t find(const std::string& name) const;
+
+    /**
+     * @brief Returns the positions of every record with the given name,
+     *        in snapshot order.
+     */
+    std::vector<size_t> findAll(const std::string& name) const;
+
+    /**
+     * @brief Returns the number of distinct names in the snapshot.
+     */
+    size_t distinct() const;
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "Hash.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace Parallel {
+/**
+ * @brief Returns the number of worker threads to use by default
+ *        (ie. the hardware concurrency, or 1 if it is unknown).
+ */
+inline unsigned defaultThreads() {
+    unsigned threads = std::thread::hardware_concurrency();
+    return threads == 0 ? 1 : threads;
+}
+
+/**
+ * @brief Splits the index range [0, n) into `threads` contiguous chunks
+ *        & calls `body(begin, end, thread)` for each chunk on its own thread.
+ *
+ * The calling thread runs the first chunk itself, & joins the others
+ * before returning.
+ *
+ * @param n The number of indices to process
+ * @param threads The number of chunks (& so threads) to use
+ * @param body A callable taking (size_t begin, size_t end, unsigned thread)
+ */
+template <typename Body>
+void forChunks(const size_t& n, unsigned threads, Body body) {
+    threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(std::max<size_t>(n, 1))));
+    size_t chunk = (n + threads - 1) / threads;
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) {
+        size_t begin = std::min(n, t * chunk);
+        size_t end = std::min(n, begin + chunk);
+        workers.emplace_back(body, begin, end, t);
+    }
+
+    body(0, std::min(n, chunk), 0u);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Sorts the range [first, last) by `comp` using `threads` threads:
+ *        each thread sorts one chunk, then neighbouring chunks are merged
+ *        pairwise (each pair on its own thread) until one run remains.
+ *
+ * @param first A random-access iterator to the beginning of the range
+ * @param last A random-access iterator to one past the end of the range
+ * @param comp The strict weak ordering to sort by
+ * @param threads The number of threads to use
+ */
+template <typename RandomIt, typename Compare>
+void sort(RandomIt first, RandomIt last, Compare comp, unsigned threads) {
+    size_t n = static_cast<size_t>(std::distance(first, last));
+    threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(std::max<size_t>(n, 1))));
+    if (threads == 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    forChunks(n, threads, [&](size_t begin, size_t end, unsigned) {
+        std::sort(first + begin, first + end, comp);
+    });
+
+    for (size_t width = (n + threads - 1) / threads; width < n; width *= 2) {
+        std::vector<std::thread> mergers;
+        for (size_t begin = 0; begin + width < n; begin += 2 * width) {
+            size_t end = std::min(n, begin + 2 * width);
+            mergers.emplace_back([=]() {
+                std::inplace_merge(first + begin, first + begin + width, first + end, comp);
+            });
+        }
+        for (std::thread& merger : mergers) {
+            merger.join();
+        }
+    }
+}
+
+/**
+ * @brief The result of `partition()`: the indices [0, n) grouped by partition,
+ *        such that partition p holds indices_[offsets_[p], offsets_[p + 1]).
+ */
+struct Partitions {
+    std::vector<size_t> offsets_; //The start of each partition in indices_ (plus the end)
+    std::vector<size_t> indices_; //The indices, in ascending order within each partition
+};
+
+/**
+ * @brief Returns the partition in which a key (eg. a group id) lies, among `parts`
+ *        partitions (the top bits of its hash), for use as the `partOf` of `partition()`.
+ */
+inline size_t partitionOf(const size_t& key, const size_t& parts) {
+    return parts <= 1 ? 0 : static_cast<size_t>(Hash::mix64(key) >> 32) % parts;
+}
+
+/**
+ * @brief Radix-partitions the index range [0, n) into `parts` partitions by
+ *        `partOf(index)`, using `threads` threads.
+ *
+ * Each thread histograms its own chunk, the histograms are prefix-summed
+ * (partition-major, then thread) & each thread scatters its chunk into its own
+ * disjoint runs, so no synchronization is needed besides the joins.
+ *
+ * @param n The number of indices to partition
+ * @param parts The number of partitions
+ * @param threads The number of threads to use
+ * @param partOf A callable mapping an index to its partition in [0, parts)
+ * @return The Partitions
+ */
+template <typename PartOf>
+Partitions partition(const size_t& n, const size_t& parts, unsigned threads, PartOf partOf) {
+    threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(std::max<size_t>(n, 1))));
+    std::vector<std::vector<size_t>> counts(threads, std::vector<size_t>(parts, 0));
+
+    forChunks(n, threads, [&](size_t begin, size_t end, unsigned t) {
+        for (size_t i = begin; i < end; ++i) {
+            counts[t][partOf(i)]++;
+        }
+    });
+
+    //Turn the counts into each thread's first slot in each partition
+    Partitions result { std::vector<size_t>(parts + 1, 0), std::vector<size_t>(n) };
+    size_t total = 0;
+    for (size_t p = 0; p < parts; ++p) {
+        result.offsets_[p] = total;
+        for (unsigned t = 0; t < threads; ++t) {
+            size_t count = counts[t][p];
+            counts[t][p] = total;
+            total += count;
+        }
+    }
+    result.offsets_[parts] = total;
+
+    forChunks(n, threads, [&](size_t begin, size_t end, unsigned t) {
+        for (size_t i = begin; i < end; ++i) {
+            result.indices_[counts[t][partOf(i)]++] = i;
+        }
+    });
+    return result;
+}
+};
@@ -1,8 +1,9 @@
 #include "Player.hpp"
 
-Player::Player(const std::string& name, const size_t& level)
+Player::Player(const std::string& name, const size_t& level, const size_t& id)
     : name_ { name }
     , level_ { level }
+    , id_ { id }
 {}
 
 bool Player::operator<(const Player& rhs) const
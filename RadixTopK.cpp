@@ -0,0 +1,198 @@
+#include "RadixTopK.hpp"
+
+namespace Online {
+/**
+ * @brief Constructs an empty container holding at most `capacity` Players.
+ *
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ */
+RadixTopK::RadixTopK(const size_t& capacity)
+    : last_ { 0 }
+    , capacity_ { capacity }
+    , size_ { 0 }
+{
+}
+
+/**
+ * @brief Returns the bucket holding a given level, relative to last_:
+ *        0 if equal, otherwise one plus the index of the highest differing bit.
+ */
+size_t RadixTopK::bucketOf(const size_t& level) const {
+    size_t diff = level ^ last_;
+    return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+}
+
+/**
+ * @brief Ensures bucket 0 holds the minimum, redistributing the first non-empty bucket.
+ *
+ * @pre The container is non-empty.
+ */
+void RadixTopK::settle() {
+    if (!buckets_[0].empty()) {
+        return;
+    }
+
+    size_t i = 1;
+    while (buckets_[i].empty()) {
+        i++;
+    }
+
+    //The new minimum becomes last_, & every Player of bucket i moves strictly lower
+    std::vector<Player> bucket;
+    bucket.swap(buckets_[i]);
+    last_ = std::min_element(bucket.begin(), bucket.end())->level_;
+    for (const Player& player : bucket) {
+        buckets_[bucketOf(player.level_)].push_back(player);
+    }
+
+    //Hand the (now empty) storage back, so bucket i need not grow again
+    bucket.clear();
+    buckets_[i].swap(bucket);
+}
+
+/**
+ * @brief Appends a Player to its bucket.
+ */
+void RadixTopK::push(const Player& player) {
+    //Only possible while filling: levels below last_ would break the invariant, so rebucket
+    if (player.level_ < last_) {
+        std::vector<Player> all = sorted();
+        for (std::vector<Player>& bucket : buckets_) {
+            bucket.clear();
+        }
+        last_ = player.level_;
+        for (const Player& kept : all) {
+            buckets_[bucketOf(kept.level_)].push_back(kept);
+        }
+    }
+
+    buckets_[bucketOf(player.level_)].push_back(player);
+    size_++;
+}
+
+/**
+ * @brief Offers a Player, which is kept if the container has room or if
+ *        it outranks the current minimum (which is then evicted).
+ *
+ * @param player A reference to the Player to be offered
+ * @return true if the Player was kept, false otherwise
+ */
+bool RadixTopK::offer(const Player& player) {
+    if (size_ < capacity_) {
+        push(player);
+        return true;
+    }
+    if (capacity_ == 0 || !(player > min())) {
+        return false;
+    }
+
+    //min() has settled bucket 0, so evicting the minimum is a pop
+    buckets_[0].pop_back();
+    size_--;
+    push(player);
+    return true;
+}
+
+/**
+ * @brief Returns the lowest leveled Player kept (ie. the cutoff).
+ *
+ * @pre The container is non-empty.
+ */
+const Player& RadixTopK::min() {
+    settle();
+    return buckets_[0].back();
+}
+
+/**
+ * @brief Returns the number of Players currently kept.
+ */
+size_t RadixTopK::size() const {
+    return size_;
+}
+
+/**
+ * @brief Returns whether the container holds `capacity` Players.
+ */
+bool RadixTopK::full() const {
+    return size_ == capacity_;
+}
+
+/**
+ * @brief Copies the Players kept, in sorted (least to greatest) order.
+ */
+std::vector<Player> RadixTopK::sorted() const {
+    std::vector<Player> players;
+    players.reserve(size_);
+    for (const std::vector<Player>& bucket : buckets_) {
+        players.insert(players.end(), bucket.begin(), bucket.end());
+    }
+    std::sort(players.begin(), players.end());
+    return players;
+}
+
+/**
+ * @brief A version of `rankIncoming()` which keeps the running leaderboard in a
+ *        `RadixTopK` rather than a binary heap.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncomingRadix(PlayerStream& stream, const size_t& reporting_interval) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Creates a radix heap for the top players and a map for cutoffs
+    RadixTopK topPlayers(reporting_interval);
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t playerCount = 0;
+
+    //Process the stream until no players remain
+    while (stream.remaining() > 0) {
+        Player currentPlayer = stream.nextPlayer();
+        playerCount++;
+
+        topPlayers.offer(currentPlayer);
+
+        if (playerCount % reporting_interval == 0) {
+            cutoffs[playerCount] = topPlayers.min().level_;
+        }
+    }
+
+    // Record cutoff for total players if not already recorded
+    if (topPlayers.size() > 0 && cutoffs.find(playerCount) == cutoffs.end()) {
+        cutoffs[playerCount] = topPlayers.min().level_;
+    }
+
+    //Sort the top players in ascending order
+    std::vector<Player> top = topPlayers.sorted();
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //Return the Ranking Result object
+    return RankingResult(top, cutoffs, elapsed);
+}
+
+/**
+ * @brief Measures `rankIncomingRadix()` against `rankIncoming()` over the same Players,
+ *        with k (ie. the reporting interval) given explicitly so that large k may be tried.
+ *
+ * @param players The Players to be ranked, in stream order
+ * @param reporting_interval The frequency at which to record cutoff levels (ie. k)
+ * @return The measured RadixStats
+ */
+RadixStats measureRadix(const std::vector<Player>& players, const size_t& reporting_interval) {
+    VectorPlayerStream heapStream(players);
+    VectorPlayerStream radixStream(players);
+    RankingResult heap = rankIncoming(heapStream, reporting_interval);
+    RankingResult radix = rankIncomingRadix(radixStream, reporting_interval);
+
+    //Players compare on level alone, so equal top_ vectors mean equal levels
+    bool matches = heap.top_ == radix.top_ && heap.cutoffs_ == radix.cutoffs_;
+    return RadixStats { heap.elapsed_, radix.elapsed_, matches };
+}
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <vector>
+
+namespace Online {
+/**
+ * @brief A bounded top-k container of Players kept in a radix heap over their
+ *        (integer) levels, as an alternative to the binary heap of `replaceMin()`.
+ *
+ * Once the top-k is full, its minimum (the cutoff) never decreases: a Player is only
+ * inserted if it beats the minimum, which is evicted to make room. That is the
+ * monotone property a radix heap relies on. Players are kept in BUCKETS buckets,
+ * where bucket i > 0 holds levels whose highest bit differing from the last
+ * extracted minimum (`last_`) is bit i - 1, & bucket 0 holds levels equal to it.
+ *
+ * - Insertion is an O(1) append to one bucket.
+ * - Finding the minimum, when bucket 0 is empty, scans the first non-empty bucket
+ *   & redistributes it into lower buckets. A Player only ever moves down, so each
+ *   is moved at most O(log C) times (C being the range of levels).
+ *
+ * Buckets are contiguous vectors & redistribution is a sequential scan, so
+ * (unlike sifting through a binary heap) operations touch memory in order.
+ *
+ * @example With a capacity of 3, offering levels 5, 1, 9, 7 leaves { 5, 7, 9 }
+ * with a cutoff of 5.
+ */
+class RadixTopK {
+private:
+    static constexpr size_t BUCKETS = 65; //One per possible highest differing bit, plus one for equality
+
+    std::vector<Player> buckets_[BUCKETS]; //Players, bucketed relative to last_
+    size_t last_; //The last extracted minimum level; every level kept is at least this
+    size_t capacity_; //The maximum number of Players kept
+    size_t size_; //The number of Players currently kept
+
+    /**
+     * @brief Returns the bucket holding a given level, relative to last_.
+     */
+    size_t bucketOf(const size_t& level) const;
+
+    /**
+     * @brief Ensures bucket 0 holds the minimum, redistributing the first non-empty bucket.
+     */
+    void settle();
+
+    /**
+     * @brief Appends a Player to its bucket.
+     */
+    void push(const Player& player);
+
+public:
+    /**
+     * @brief Constructs an empty container holding at most `capacity` Players.
+     *
+     * @param capacity The number of Players to keep (ie. the k in top-k)
+     */
+    RadixTopK(const size_t& capacity);
+
+    /**
+     * @brief Offers a Player, which is kept if the container has room or if
+     *        it outranks the current minimum (which is then evicted).
+     *
+     * Performs in amortized O(log C) time.
+     *
+     * @param player A reference to the Player to be offered
+     * @return true if the Player was kept, false otherwise
+     */
+    bool offer(const Player& player);
+
+    /**
+     * @brief Returns the lowest leveled Player kept (ie. the cutoff).
+     *
+     * @pre The container is non-empty.
+     */
+    const Player& min();
+
+    /**
+     * @brief Returns the number of Players currently kept.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns whether the container holds `capacity` Players.
+     */
+    bool full() const;
+
+    /**
+     * @brief Copies the Players kept, in sorted (least to greatest) order.
+     */
+    std::vector<Player> sorted() const;
+};
+
+/**
+ * @brief A version of `rankIncoming()` which keeps the running leaderboard in a
+ *        `RadixTopK` rather than a binary heap.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncomingRadix(PlayerStream& stream, const size_t& reporting_interval);
+
+/**
+ * @brief Measurements of the radix heap against the binary heap of `rankIncoming()`.
+ */
+struct RadixStats {
+    double heapElapsed_; //Duration (ms) of ranking via the replaceMin() binary heap
+    double radixElapsed_; //Duration (ms) of ranking via RadixTopK
+    bool matches_; //Whether both ranked the same top-k levels & cutoffs
+};
+
+/**
+ * @brief Measures `rankIncomingRadix()` against `rankIncoming()` over the same Players,
+ *        with k (ie. the reporting interval) given explicitly so that large k may be tried.
+ *
+ * @param players The Players to be ranked, in stream order
+ * @param reporting_interval The frequency at which to record cutoff levels (ie. k)
+ * @return The measured RadixStats
+ */
+RadixStats measureRadix(const std::vector<Player>& players, const size_t& reporting_interval);
+};
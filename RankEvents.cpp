@@ -0,0 +1,184 @@
+#include "RankEvents.hpp"
+
+/**
+ * @brief Constructs an empty registry.
+ */
+SubscriptionRegistry::SubscriptionRegistry()
+    : published_ { 0 }
+    , delivered_ { 0 }
+{
+}
+
+/**
+ * @brief Subscribes a Player to its leaderboard entry & exit notifications,
+ *        replacing any previous subscription of the same id.
+ *
+ * @param id The Player's id
+ * @param callback Called (from `flush()`) with an Entered or Left event whenever
+ *        the Player's membership has changed over an interval
+ */
+void SubscriptionRegistry::subscribe(const size_t& id, Callback callback) {
+    Subscription& subscription = subscriptions_[id];
+    subscription.callback_ = std::move(callback);
+    subscription.entries_ = 0;
+    subscription.notifiedIn_ = false;
+    subscription.dirty_ = false;
+}
+
+/**
+ * @brief Cancels a Player's subscription (& any pending notification).
+ */
+void SubscriptionRegistry::unsubscribe(const size_t& id) {
+    //A stale id left in dirty_ is skipped by flush()
+    subscriptions_.erase(id);
+}
+
+/**
+ * @brief Records an event, in O(1).
+ */
+void SubscriptionRegistry::publish(const RankEvent& event) {
+    auto it = subscriptions_.find(event.id_);
+    if (it == subscriptions_.end()) {
+        return;
+    }
+
+    Subscription& subscription = it->second;
+    subscription.entries_ += event.kind_ == RankEvent::Kind::Entered ? 1 : -1;
+    subscription.last_ = event;
+    published_++;
+
+    if (!subscription.dirty_) {
+        subscription.dirty_ = true;
+        dirty_.push_back(event.id_);
+    }
+}
+
+/**
+ * @brief Notifies every subscriber whose membership changed since the last flush.
+ *
+ * A callback may publish events itself; those of subscribers already notified by
+ * this flush are left for the next one.
+ *
+ * @return The number of notifications delivered
+ */
+size_t SubscriptionRegistry::flush() {
+    //Take the list, so a callback's publish() appends to a fresh one
+    std::vector<size_t> pending;
+    pending.swap(dirty_);
+
+    size_t delivered = 0;
+    for (const size_t& id : pending) {
+        auto it = subscriptions_.find(id);
+        if (it == subscriptions_.end() || !it->second.dirty_) {
+            continue;
+        }
+
+        Subscription& subscription = it->second;
+        subscription.dirty_ = false;
+        bool in = subscription.entries_ > 0;
+        if (in == subscription.notifiedIn_) {
+            continue;
+        }
+
+        //Report the net change, at the latest event's level & position
+        subscription.notifiedIn_ = in;
+        RankEvent event = subscription.last_;
+        event.kind_ = in ? RankEvent::Kind::Entered : RankEvent::Kind::Left;
+        subscription.callback_(event);
+        delivered++;
+    }
+
+    //Hand the list's storage back, unless callbacks published meanwhile
+    if (dirty_.empty()) {
+        pending.clear();
+        dirty_.swap(pending);
+    }
+    delivered_ += delivered;
+    return delivered;
+}
+
+/**
+ * @brief Returns the number of Players subscribed.
+ */
+size_t SubscriptionRegistry::size() const {
+    return subscriptions_.size();
+}
+
+/**
+ * @brief Returns the number of events published for subscribers so far.
+ */
+size_t SubscriptionRegistry::published() const {
+    return published_;
+}
+
+/**
+ * @brief Returns the number of notifications delivered so far (at most published()).
+ */
+size_t SubscriptionRegistry::delivered() const {
+    return delivered_;
+}
+
+namespace Online {
+/**
+ * @brief A version of `rankIncoming()` which publishes an Entered event for every
+ *        Player taking a slot & a Left event for every Player evicted by `replaceMin()`,
+ *        flushing the registry at every reporting milestone (& at the end of the stream).
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels & flush notifications
+ * @param subscriptions The registry to publish events to
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, SubscriptionRegistry& subscriptions) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Creates a vector to store the top players and a map for cutoffs
+    std::vector<Player> topPlayers;
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t playerCount = 0;
+
+    //Process the stream until no players remain
+    while (stream.remaining() > 0) {
+        Player currentPlayer = stream.nextPlayer();
+        playerCount++;
+
+        if (topPlayers.size() < reporting_interval) {
+            subscriptions.publish(RankEvent { RankEvent::Kind::Entered, currentPlayer.id_, currentPlayer.level_, playerCount });
+            topPlayers.push_back(currentPlayer);
+            if (topPlayers.size() == reporting_interval) {
+                std::make_heap(topPlayers.begin(), topPlayers.end(), std::greater<Player>());
+            }
+        } else if (currentPlayer > topPlayers.front()) {
+            //The minimum is about to be evicted by replaceMin()
+            const Player& evicted = topPlayers.front();
+            subscriptions.publish(RankEvent { RankEvent::Kind::Left, evicted.id_, evicted.level_, playerCount });
+            subscriptions.publish(RankEvent { RankEvent::Kind::Entered, currentPlayer.id_, currentPlayer.level_, playerCount });
+            replaceMin(topPlayers.begin(), topPlayers.end(), currentPlayer);
+        }
+
+        if (playerCount % reporting_interval == 0) {
+            cutoffs[playerCount] = topPlayers.front().level_;
+            subscriptions.flush();
+        }
+    }
+
+    // Record cutoff for total players if not already recorded
+    if (cutoffs.find(playerCount) == cutoffs.end()) {
+        cutoffs[playerCount] = topPlayers.front().level_;
+    }
+    subscriptions.flush();
+
+    //Sort the top players in ascending order
+    std::sort(topPlayers.begin(), topPlayers.end());
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //Return the Ranking Result object
+    return RankingResult(topPlayers, cutoffs, elapsed);
+}
+};
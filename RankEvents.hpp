@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A change to the online leaderboard, as emitted by `replaceMin()` evictions
+ *        (& the insertions which cause them).
+ */
+struct RankEvent {
+    enum class Kind {
+        Entered, //The Player took a slot on the leaderboard
+        Left //The Player was evicted from the leaderboard
+    };
+
+    Kind kind_;
+    size_t id_; //The Player's id
+    size_t level_; //The level at which the Player entered (or left)
+    size_t position_; //The player count (ie. position in the stream) at which it happened
+};
+
+/**
+ * @brief A registry of per-Player subscriptions to "tell me when I enter/leave the
+ *        leaderboard", which batches notifications per reporting interval.
+ *
+ * Subscriptions are kept in a hash map keyed by Player id, so `publish()` is one
+ * O(1) lookup per event however many Players have subscribed (events for Players
+ * without a subscription are dropped there & then). An event for a subscriber only
+ * updates its net membership (the number of its entries on the leaderboard) & marks
+ * it dirty; `flush()` then notifies each dirty subscriber at most once, & only if its
+ * membership differs from that at the previous flush. So a Player who enters & is
+ * evicted within one interval is not notified at all.
+ *
+ * Subscriptions should be made before ingestion starts: a subscriber is assumed
+ * to be off the leaderboard when it subscribes.
+ */
+class SubscriptionRegistry {
+public:
+    using Callback = std::function<void(const RankEvent&)>;
+
+private:
+    /**
+     * @brief A subscription & its membership state.
+     */
+    struct Subscription {
+        Callback callback_; //Called with the net event at a flush
+        long entries_; //The number of the Player's entries on the leaderboard
+        bool notifiedIn_; //Whether the Player was on the leaderboard at the last flush
+        bool dirty_; //Whether the Player is listed in dirty_ for the next flush
+        RankEvent last_; //The latest event published for the Player
+    };
+
+    std::unordered_map<size_t, Subscription> subscriptions_; //Subscriptions, by Player id
+    std::vector<size_t> dirty_; //The ids with events since the last flush
+    size_t published_; //The number of events for subscribers
+    size_t delivered_; //The number of notifications delivered
+
+public:
+    /**
+     * @brief Constructs an empty registry.
+     */
+    SubscriptionRegistry();
+
+    /**
+     * @brief Subscribes a Player to its leaderboard entry & exit notifications,
+     *        replacing any previous subscription of the same id.
+     *
+     * @param id The Player's id
+     * @param callback Called (from `flush()`) with an Entered or Left event whenever
+     *        the Player's membership has changed over an interval
+     */
+    void subscribe(const size_t& id, Callback callback);
+
+    /**
+     * @brief Cancels a Player's subscription (& any pending notification).
+     */
+    void unsubscribe(const size_t& id);
+
+    /**
+     * @brief Records an event, in O(1).
+     */
+    void publish(const RankEvent& event);
+
+    /**
+     * @brief Notifies every subscriber whose membership changed since the last flush.
+     *
+     * A callback may publish events itself; those of subscribers already notified by
+     * this flush are left for the next one.
+     *
+     * @return The number of notifications delivered
+     */
+    size_t flush();
+
+    /**
+     * @brief Returns the number of Players subscribed.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the number of events published for subscribers so far.
+     */
+    size_t published() const;
+
+    /**
+     * @brief Returns the number of notifications delivered so far (at most published()).
+     */
+    size_t delivered() const;
+};
+
+namespace Online {
+/**
+ * @brief A version of `rankIncoming()` which publishes an Entered event for every
+ *        Player taking a slot & a Left event for every Player evicted by `replaceMin()`,
+ *        flushing the registry at every reporting milestone (& at the end of the stream).
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels & flush notifications
+ * @param subscriptions The registry to publish events to
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncoming(PlayerStream& stream, const size_t& reporting_interval, SubscriptionRegistry& subscriptions);
+};
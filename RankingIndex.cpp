@@ -0,0 +1,300 @@
+#include "RankingIndex.hpp"
+#include "AtomicFile.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+const char MAGIC[8] = { 'P', 'L', 'R', 'I', 'D', 'X', '0', '1' };
+
+/**
+ * @brief Rounds a byte offset up to the next multiple of 8.
+ */
+uint64_t align8(const uint64_t& offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+};
+
+/**
+ * @brief The fixed header at the start of an index file.
+ */
+struct RankingIndex::Header {
+    char magic_[8];
+    uint64_t playerCount_; //The number of Players in the table ranked
+    uint64_t topCount_; //The number of TopRecords (& RankRecords)
+    uint64_t topOffset_;
+    uint64_t namesOffset_;
+    uint64_t namesBytes_;
+    uint64_t cutoffCount_;
+    uint64_t cutoffOffset_;
+    uint64_t bucketOffset_;
+    uint64_t rankOffset_;
+    uint64_t fileBytes_; //The total length of the file
+};
+
+/**
+ * @brief A ranked Player; its name is names_[nameOffset_, nameOffset_ + nameBytes_).
+ */
+struct RankingIndex::TopRecord {
+    uint64_t level_;
+    uint64_t id_;
+    uint64_t nameOffset_;
+    uint64_t nameBytes_;
+};
+
+/**
+ * @brief The cutoff level at a player count milestone.
+ */
+struct RankingIndex::CutoffRecord {
+    uint64_t count_;
+    uint64_t level_;
+};
+
+/**
+ * @brief The rank of a Player (1 being the highest).
+ */
+struct RankingIndex::RankRecord {
+    uint64_t id_;
+    uint64_t rank_;
+};
+
+/**
+ * @brief Writes the index of an offline run.
+ *
+ * The index is written to `<path>.tmp`, synced, then renamed over `path` (see
+ * `AtomicFile::replace()`), so a RankingIndex mapping the previous file keeps reading
+ * it unchanged, & a crash leaves either the previous index or the new one.
+ *
+ * @param path The path of the file to be (over)written
+ * @param result The result of the run (eg. of `Offline::quickSelectRank()`)
+ * @param players The whole table which was ranked (for the level distribution)
+ *
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void RankingIndex::write(const std::string& path, const RankingResult& result, const std::vector<Player>& players) {
+    const std::vector<Player>& top = result.top_;
+
+    //Lay out the sections
+    std::vector<TopRecord> records;
+    std::string names;
+    records.reserve(top.size());
+    for (const Player& player : top) {
+        records.push_back(TopRecord { player.level_, player.id_, names.size(), player.name_.size() });
+        names += player.name_;
+    }
+
+    std::vector<CutoffRecord> cutoffs;
+    for (const auto& cutoff : result.cutoffs_) {
+        cutoffs.push_back(CutoffRecord { cutoff.first, cutoff.second });
+    }
+    std::sort(cutoffs.begin(), cutoffs.end(), [](const CutoffRecord& a, const CutoffRecord& b) {
+        return a.count_ < b.count_;
+    });
+
+    std::vector<uint64_t> buckets(LevelHistogram::BUCKETS + 1, 0);
+    for (const Player& player : players) {
+        buckets[LevelHistogram::bucketOf(player.level_) + 1]++;
+    }
+    for (size_t b = 1; b < buckets.size(); ++b) {
+        buckets[b] += buckets[b - 1];
+    }
+
+    std::vector<RankRecord> ranks;
+    ranks.reserve(top.size());
+    for (size_t i = 0; i < top.size(); ++i) {
+        ranks.push_back(RankRecord { top[i].id_, top.size() - i });
+    }
+    std::sort(ranks.begin(), ranks.end(), [](const RankRecord& a, const RankRecord& b) {
+        return a.id_ < b.id_ || (a.id_ == b.id_ && a.rank_ < b.rank_);
+    });
+
+    Header header {};
+    std::memcpy(header.magic_, MAGIC, sizeof(MAGIC));
+    header.playerCount_ = players.size();
+    header.topCount_ = top.size();
+    header.topOffset_ = align8(sizeof(Header));
+    header.namesOffset_ = header.topOffset_ + records.size() * sizeof(TopRecord);
+    header.namesBytes_ = names.size();
+    header.cutoffCount_ = cutoffs.size();
+    header.cutoffOffset_ = align8(header.namesOffset_ + names.size());
+    header.bucketOffset_ = header.cutoffOffset_ + cutoffs.size() * sizeof(CutoffRecord);
+    header.rankOffset_ = header.bucketOffset_ + buckets.size() * sizeof(uint64_t);
+    header.fileBytes_ = header.rankOffset_ + ranks.size() * sizeof(RankRecord);
+
+    //Write a temporary file & rename it over the index, never truncating a mapped file
+    const char padding[8] = {};
+    bool written = AtomicFile::replace(path, [&](const int& fd) {
+        return AtomicFile::writeAll(fd, &header, sizeof(Header))
+            && AtomicFile::writeAll(fd, padding, header.topOffset_ - sizeof(Header))
+            && AtomicFile::writeAll(fd, records.data(), records.size() * sizeof(TopRecord))
+            && AtomicFile::writeAll(fd, names.data(), names.size())
+            && AtomicFile::writeAll(fd, padding, header.cutoffOffset_ - (header.namesOffset_ + names.size()))
+            && AtomicFile::writeAll(fd, cutoffs.data(), cutoffs.size() * sizeof(CutoffRecord))
+            && AtomicFile::writeAll(fd, buckets.data(), buckets.size() * sizeof(uint64_t))
+            && AtomicFile::writeAll(fd, ranks.data(), ranks.size() * sizeof(RankRecord));
+    });
+    if (!written) {
+        throw std::runtime_error("Cannot write ranking index " + path);
+    }
+}
+
+/**
+ * @brief Maps an index file into memory, validating its header & section bounds.
+ *
+ * @param path The path of the index file
+ *
+ * @throws std::runtime_error If the file cannot be mapped or is not a (valid) index.
+ */
+RankingIndex::RankingIndex(const std::string& path)
+    : data_ { nullptr }
+    , bytes_ { 0 }
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open ranking index " + path);
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        ::close(fd);
+        throw std::runtime_error(path + " is not a ranking index");
+    }
+
+    bytes_ = static_cast<size_t>(info.st_size);
+    data_ = ::mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+        throw std::runtime_error("Cannot map ranking index " + path);
+    }
+
+    //Validate every section against the mapping before serving from it (bounding each
+    //count & offset by the file length first, so that the sums below cannot overflow)
+    const char* base = static_cast<const char*>(data_);
+    header_ = reinterpret_cast<const Header*>(base);
+    const Header& h = *header_;
+    bool valid = std::memcmp(h.magic_, MAGIC, sizeof(MAGIC)) == 0
+        && h.fileBytes_ == bytes_
+        && h.topCount_ <= bytes_ && h.cutoffCount_ <= bytes_ && h.namesBytes_ <= bytes_
+        && h.topOffset_ <= bytes_ && h.namesOffset_ <= bytes_ && h.cutoffOffset_ <= bytes_
+        && h.bucketOffset_ <= bytes_ && h.rankOffset_ <= bytes_
+        && h.topOffset_ + h.topCount_ * sizeof(TopRecord) <= h.namesOffset_
+        && h.namesOffset_ + h.namesBytes_ <= h.cutoffOffset_
+        && h.cutoffOffset_ + h.cutoffCount_ * sizeof(CutoffRecord) <= h.bucketOffset_
+        && h.bucketOffset_ + (LevelHistogram::BUCKETS + 1) * sizeof(uint64_t) <= h.rankOffset_
+        && h.rankOffset_ + h.topCount_ * sizeof(RankRecord) <= bytes_;
+    if (!valid) {
+        ::munmap(data_, bytes_);
+        data_ = nullptr;
+        throw std::runtime_error(path + " is not a valid ranking index");
+    }
+
+    top_ = reinterpret_cast<const TopRecord*>(base + h.topOffset_);
+    names_ = base + h.namesOffset_;
+    cutoffs_ = reinterpret_cast<const CutoffRecord*>(base + h.cutoffOffset_);
+    buckets_ = reinterpret_cast<const uint64_t*>(base + h.bucketOffset_);
+    ranks_ = reinterpret_cast<const RankRecord*>(base + h.rankOffset_);
+}
+
+RankingIndex::RankingIndex(RankingIndex&& other) noexcept
+    : data_ { other.data_ }
+    , bytes_ { other.bytes_ }
+    , header_ { other.header_ }
+    , top_ { other.top_ }
+    , names_ { other.names_ }
+    , cutoffs_ { other.cutoffs_ }
+    , buckets_ { other.buckets_ }
+    , ranks_ { other.ranks_ }
+{
+    other.data_ = nullptr;
+}
+
+RankingIndex::~RankingIndex() {
+    if (data_ != nullptr) {
+        ::munmap(data_, bytes_);
+    }
+}
+
+/**
+ * @brief Returns the number of ranked Players (ie. the length of the top segment).
+ */
+size_t RankingIndex::size() const {
+    return header_->topCount_;
+}
+
+/**
+ * @brief Returns the number of Players in the table which was ranked.
+ */
+size_t RankingIndex::playerCount() const {
+    return header_->playerCount_;
+}
+
+/**
+ * @brief Returns the i-th ranked Player in ascending order (as RankingResult::top_).
+ *
+ * @throws std::out_of_range If i is not less than size().
+ */
+RankingIndex::Entry RankingIndex::at(const size_t& i) const {
+    if (i >= header_->topCount_) {
+        throw std::out_of_range("Rank index " + std::to_string(i) + " is past the top segment");
+    }
+
+    const TopRecord& record = top_[i];
+    if (record.nameOffset_ + record.nameBytes_ > header_->namesBytes_) {
+        throw std::out_of_range("Name of ranked player " + std::to_string(i) + " lies outside the index");
+    }
+    return Entry { record.level_, record.id_, std::string_view(names_ + record.nameOffset_, record.nameBytes_) };
+}
+
+/**
+ * @brief Returns the rank of a Player (1 being the highest), or 0 if it is unranked,
+ *        by binary search of the id -> rank map.
+ */
+size_t RankingIndex::rankOf(const size_t& id) const {
+    const RankRecord* last = ranks_ + header_->topCount_;
+    const RankRecord* it = std::lower_bound(ranks_, last, id, [](const RankRecord& record, const size_t& key) {
+        return record.id_ < key;
+    });
+    return it != last && it->id_ == id ? it->rank_ : 0;
+}
+
+/**
+ * @brief Returns the cutoff level recorded at a player count milestone.
+ *
+ * @throws std::out_of_range If no cutoff was recorded at `count`.
+ */
+size_t RankingIndex::cutoffAt(const size_t& count) const {
+    const CutoffRecord* last = cutoffs_ + header_->cutoffCount_;
+    const CutoffRecord* it = std::lower_bound(cutoffs_, last, count, [](const CutoffRecord& record, const size_t& key) {
+        return record.count_ < key;
+    });
+    if (it == last || it->count_ != count) {
+        throw std::out_of_range("No cutoff recorded at " + std::to_string(count) + " players");
+    }
+    return it->level_;
+}
+
+/**
+ * @brief Returns the cutoffs recorded, as (player count, level) pairs in ascending order.
+ */
+std::vector<std::pair<size_t, size_t>> RankingIndex::cutoffs() const {
+    std::vector<std::pair<size_t, size_t>> cutoffs;
+    cutoffs.reserve(header_->cutoffCount_);
+    for (size_t i = 0; i < header_->cutoffCount_; ++i) {
+        cutoffs.emplace_back(cutoffs_[i].count_, cutoffs_[i].level_);
+    }
+    return cutoffs;
+}
+
+/**
+ * @brief Returns the number of Players of the table whose level falls in the same
+ *        `LevelHistogram` bucket as `level` or above, in O(1).
+ */
+size_t RankingIndex::countAtLeast(const size_t& level) const {
+    return buckets_[LevelHistogram::BUCKETS] - buckets_[LevelHistogram::bucketOf(level)];
+}
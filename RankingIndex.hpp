@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief A precomputed, read-only ranking index file, written after an offline run so
+ *        that a restarting service can serve queries straight from disk.
+ *
+ * The file is position-independent: a fixed header of 64-bit counts & byte offsets
+ * (from the start of the file) to 8-byte aligned sections, all little-endian as on
+ * the writing machine:
+ * - The top segment: one TopRecord {level, id, name offset, name length} per ranked
+ *   Player, in ascending order (as RankingResult::top_), & a blob of their names.
+ * - The cutoffs: {player count, level} pairs, in ascending order of player count.
+ * - The level distribution of the whole table: BUCKETS + 1 prefix counts over the
+ *   `LevelHistogram` buckets (ie. entry b is the number of Players below bucket b).
+ * - The id -> rank map: {id, rank} pairs in ascending order of id, where rank 1 is
+ *   the highest leveled Player.
+ *
+ * A loaded index maps the file into memory & reads these sections in place, so
+ * opening it costs a handful of system calls regardless of its size.
+ */
+class RankingIndex {
+public:
+    /**
+     * @brief A ranked Player as held in the index; the name points into the mapping.
+     */
+    struct Entry {
+        size_t level_;
+        size_t id_;
+        std::string_view name_;
+    };
+
+    /**
+     * @brief Writes the index of an offline run.
+     *
+     * The index is written to `<path>.tmp`, synced, then renamed over `path` (see
+     * `AtomicFile::replace()`), so a RankingIndex mapping the previous file keeps reading
+     * it unchanged, & a crash leaves either the previous index or the new one.
+     *
+     * @param path The path of the file to be (over)written
+     * @param result The result of the run (eg. of `Offline::quickSelectRank()`)
+     * @param players The whole table which was ranked (for the level distribution)
+     *
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    static void write(const std::string& path, const RankingResult& result, const std::vector<Player>& players);
+
+private:
+    struct Header;
+    struct TopRecord;
+    struct CutoffRecord;
+    struct RankRecord;
+
+    void* data_; //The start of the mapping
+    size_t bytes_; //The length of the mapping
+    const Header* header_; //The header, at the start of the mapping
+    const TopRecord* top_; //The top segment
+    const char* names_; //The name blob
+    const CutoffRecord* cutoffs_; //The cutoffs
+    const uint64_t* buckets_; //The BUCKETS + 1 prefix counts
+    const RankRecord* ranks_; //The id -> rank map
+
+public:
+    /**
+     * @brief Maps an index file into memory, validating its header & section bounds.
+     *
+     * @param path The path of the index file
+     *
+     * @throws std::runtime_error If the file cannot be mapped or is not a (valid) index.
+     */
+    explicit RankingIndex(const std::string& path);
+    RankingIndex(const RankingIndex&) = delete;
+    RankingIndex& operator=(const RankingIndex&) = delete;
+    RankingIndex(RankingIndex&& other) noexcept;
+    ~RankingIndex();
+
+    /**
+     * @brief Returns the number of ranked Players (ie. the length of the top segment).
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the number of Players in the table which was ranked.
+     */
+    size_t playerCount() const;
+
+    /**
+     * @brief Returns the i-th ranked Player in ascending order (as RankingResult::top_).
+     *
+     * @throws std::out_of_range If i is not less than size().
+     */
+    Entry at(const size_t& i) const;
+
+    /**
+     * @brief Returns the rank of a Player (1 being the highest), or 0 if it is unranked,
+     *        by binary search of the id -> rank map.
+     */
+    size_t rankOf(const size_t& id) const;
+
+    /**
+     * @brief Returns the cutoff level recorded at a player count milestone.
+     *
+     * @throws std::out_of_range If no cutoff was recorded at `count`.
+     */
+    size_t cutoffAt(const size_t& count) const;
+
+    /**
+     * @brief Returns the cutoffs recorded, as (player count, level) pairs in ascending order.
+     */
+    std::vector<std::pair<size_t, size_t>> cutoffs() const;
+
+    /**
+     * @brief Returns the number of Players of the table whose level falls in the same
+     *        `LevelHistogram` bucket as `level` or above (ie. at least
+     *        `lowerBound(bucketOf(level))`), in O(1).
+     */
+    size_t countAtLeast(const size_t& level) const;
+};
@@ -0,0 +1,249 @@
+#include "RelaxedTopK.hpp"
+#include "Parallel.hpp"
+
+namespace {
+/**
+ * @brief Draws a random index in [0, n) from a per-thread xorshift generator.
+ */
+size_t randomIndex(const size_t& n) {
+    thread_local uint64_t state = 0x2545f4914f6cdd1dULL ^ reinterpret_cast<uintptr_t>(&state);
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<size_t>(state % n);
+}
+
+/**
+ * @brief Offers a slice of Players to a plain bounded min-heap, as `rankIncoming()` does.
+ */
+void offerAll(std::vector<Player>& heap, const size_t& capacity, const std::vector<Player>& players, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        if (heap.size() < capacity) {
+            heap.push_back(players[i]);
+            if (heap.size() == capacity) {
+                std::make_heap(heap.begin(), heap.end(), std::greater<Player>());
+            }
+        } else if (players[i] > heap.front()) {
+            Player target = players[i];
+            Online::replaceMin(heap.begin(), heap.end(), target);
+        }
+    }
+}
+
+/**
+ * @brief Keeps the best `capacity` of a collection of Players, in sorted (ascending) order.
+ */
+void keepTop(std::vector<Player>& players, const size_t& capacity) {
+    if (players.size() > capacity) {
+        std::nth_element(players.begin(), players.end() - capacity, players.end());
+        players.erase(players.begin(), players.end() - capacity);
+    }
+    std::sort(players.begin(), players.end());
+}
+};
+
+namespace Online {
+/**
+ * @brief Constructs an empty board.
+ *
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param queues The number of sub-heaps (typically 2-4 per offering thread)
+ */
+RelaxedTopK::RelaxedTopK(const size_t& capacity, const size_t& queues)
+    : capacity_ { capacity }
+    , heaps_ { new SubHeap[std::max<size_t>(queues, 1)] }
+    , count_ { std::max<size_t>(queues, 1) }
+    , bestCutoff_ { 0 }
+{
+}
+
+/**
+ * @brief Inserts a Player into a locked sub-heap, publishing its cutoff once full.
+ */
+void RelaxedTopK::insert(SubHeap& heap, const Player& player) {
+    if (heap.heap_.size() < capacity_) {
+        heap.heap_.push_back(player);
+        if (heap.heap_.size() < capacity_) {
+            return;
+        }
+        std::make_heap(heap.heap_.begin(), heap.heap_.end(), std::greater<Player>());
+    } else if (player > heap.heap_.front()) {
+        Player target = player;
+        replaceMin(heap.heap_.begin(), heap.heap_.end(), target);
+    } else {
+        return;
+    }
+
+    //Publish the (raised) cutoff, & raise the best cutoff if this one beats it
+    size_t cutoff = heap.heap_.front().level_ + 1;
+    heap.cutoff_.store(cutoff, std::memory_order_release);
+    size_t best = bestCutoff_.load(std::memory_order_relaxed);
+    while (cutoff > best && !bestCutoff_.compare_exchange_weak(best, cutoff, std::memory_order_acq_rel)) {
+    }
+}
+
+/**
+ * @brief Offers a Player; safe to call from any number of threads at once.
+ *
+ * @param player A reference to the Player to be offered
+ * @return true if a sub-heap kept the Player, false otherwise
+ */
+bool RelaxedTopK::offer(const Player& player) {
+    if (capacity_ == 0) {
+        return false;
+    }
+
+    //A full sub-heap already holds k Players at least this high
+    if (player.level_ + 1 <= bestCutoff_.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    while (true) {
+        //Pick two sub-heaps at random, & prefer the one with the lower cutoff
+        SubHeap* a = &heaps_[randomIndex(count_)];
+        SubHeap* b = &heaps_[randomIndex(count_)];
+        SubHeap* better = b->cutoff_.load(std::memory_order_relaxed) < a->cutoff_.load(std::memory_order_relaxed) ? b : a;
+
+        bool expected = false;
+        if (!better->locked_.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            continue;
+        }
+
+        bool kept = better->heap_.size() < capacity_ || player > better->heap_.front();
+        insert(*better, player);
+        better->locked_.store(false, std::memory_order_release);
+        return kept;
+    }
+}
+
+/**
+ * @brief Returns a lock-free lower bound on the exact cutoff (0 until a sub-heap is full).
+ */
+size_t RelaxedTopK::approximateCutoff() const {
+    size_t best = bestCutoff_.load(std::memory_order_acquire);
+    return best == 0 ? 0 : best - 1;
+}
+
+/**
+ * @brief Merges the sub-heaps into the exact top-k.
+ *
+ * @pre No other thread is offering Players.
+ * @return The top <capacity> Players offered, in sorted (least to greatest) order
+ */
+std::vector<Player> RelaxedTopK::flush() const {
+    std::vector<Player> players;
+    for (size_t i = 0; i < count_; ++i) {
+        players.insert(players.end(), heaps_[i].heap_.begin(), heaps_[i].heap_.end());
+    }
+    keepTop(players, capacity_);
+    return players;
+}
+
+/**
+ * @brief Ranks a collection of Players by offering equal slices of it from several
+ *        threads at once into a shared `RelaxedTopK`, then flushing it.
+ *
+ * @param players The Players to be ranked
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param threads The number of threads offering Players
+ * @param queues_per_thread The number of sub-heaps per thread
+ * @return A RankingResult in which:
+ * - top_       -> Contains the top <capacity> Players in sorted (least to greatest) order
+ * - cutoffs_   -> Is empty
+ * - elapsed_   -> Contains the duration (ms) of the concurrent offers & the flush
+ */
+RankingResult rankRelaxed(const std::vector<Player>& players, const size_t& capacity, const unsigned& threads, const size_t& queues_per_thread) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    RelaxedTopK board(capacity, std::max(1u, threads) * std::max<size_t>(queues_per_thread, 1));
+    Parallel::forChunks(players.size(), threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) {
+            board.offer(players[i]);
+        }
+    });
+    std::vector<Player> topPlayers = board.flush();
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return RankingResult(topPlayers, {}, elapsed);
+}
+
+/**
+ * @brief The exact sharded approach: each thread runs the `rankIncoming()` heap
+ *        over its own slice, & the per-thread heaps are merged at the end.
+ *
+ * @param players The Players to be ranked
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param threads The number of threads (& so shards)
+ * @return A RankingResult as for `rankRelaxed()`
+ */
+RankingResult rankSharded(const std::vector<Player>& players, const size_t& capacity, const unsigned& threads) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::vector<Player>> shards(std::max(1u, threads));
+    Parallel::forChunks(players.size(), threads, [&](size_t begin, size_t end, unsigned t) {
+        offerAll(shards[t], capacity, players, begin, end);
+    });
+
+    std::vector<Player> topPlayers;
+    for (const std::vector<Player>& shard : shards) {
+        topPlayers.insert(topPlayers.end(), shard.begin(), shard.end());
+    }
+    keepTop(topPlayers, capacity);
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return RankingResult(topPlayers, {}, elapsed);
+}
+
+/**
+ * @brief Measures the throughput of `rankRelaxed()` against `rankSharded()`, & the rank
+ *        error of the relaxed in-flight cutoff.
+ *
+ * @param players The Players to be ranked
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param threads The number of threads offering Players
+ * @param rounds The number of points at which to sample the rank error
+ * @return The measured RelaxedStats
+ */
+RelaxedStats measureRelaxed(const std::vector<Player>& players, const size_t& capacity, const unsigned& threads, const size_t& rounds) {
+    RelaxedStats stats { rankRelaxed(players, capacity, threads).elapsed_, rankSharded(players, capacity, threads).elapsed_, 0, 0 };
+
+    //Replay in rounds, sampling the in-flight cutoff between them
+    RelaxedTopK board(capacity, std::max(1u, threads) * 2);
+    size_t perRound = (players.size() + std::max<size_t>(rounds, 1) - 1) / std::max<size_t>(rounds, 1);
+    size_t samples = 0;
+    double totalError = 0;
+
+    for (size_t begin = 0; begin < players.size(); begin += perRound) {
+        size_t end = std::min(players.size(), begin + perRound);
+        Parallel::forChunks(end - begin, threads, [&](size_t b, size_t e, unsigned) {
+            for (size_t i = begin + b; i < begin + e; ++i) {
+                board.offer(players[i]);
+            }
+        });
+
+        //Only meaningful once at least k Players have been offered
+        if (end < capacity || capacity == 0) {
+            continue;
+        }
+
+        size_t estimate = board.approximateCutoff();
+        size_t above = std::count_if(players.begin(), players.begin() + end, [&](const Player& p) { return p.level_ > estimate; });
+        size_t error = above + 1 > capacity ? above + 1 - capacity : 0;
+
+        totalError += error;
+        stats.maxRankError_ = std::max(stats.maxRankError_, error);
+        samples++;
+    }
+
+    stats.meanRankError_ = samples == 0 ? 0 : totalError / samples;
+    return stats;
+}
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Online {
+/**
+ * @brief A relaxed (MultiQueue-style) concurrent top-k, trading the exactness of its
+ *        in-flight state for throughput: suited to live "approximate top" widgets.
+ *
+ * Players are spread over several independent sub-heaps, each a bounded min-heap
+ * of k Players maintained with `replaceMin()` behind its own spinlock. To offer a
+ * Player, a thread picks two sub-heaps at random & inserts into the better one
+ * (ie. the one with the lower cutoff), so threads rarely contend for one lock.
+ *
+ * Each sub-heap keeps the top-k of what it was offered, & a Player is only ever
+ * rejected at the cutoff of a full sub-heap (which holds k Players at least as high).
+ * So no Player of the exact top-k is lost, & `flush()` converges to the exact
+ * top-k by merging the sub-heaps. In flight, `approximateCutoff()` is a lock-free
+ * lower bound on the exact cutoff.
+ */
+class RelaxedTopK {
+private:
+    /**
+     * @brief One sub-heap, padded to its own cache lines.
+     */
+    struct alignas(64) SubHeap {
+        std::atomic<bool> locked_ { false }; //A spinlock guarding heap_
+        std::atomic<size_t> cutoff_ { 0 }; //The published cutoff + 1 once full, or 0
+        std::vector<Player> heap_; //Min-heap by level, once full
+    };
+
+    size_t capacity_; //The number of Players to keep (ie. the k in top-k)
+    std::unique_ptr<SubHeap[]> heaps_; //The sub-heaps
+    size_t count_; //The number of sub-heaps
+    std::atomic<size_t> bestCutoff_; //The highest published sub-heap cutoff + 1, or 0
+
+    /**
+     * @brief Inserts a Player into a locked sub-heap, publishing its cutoff once full.
+     */
+    void insert(SubHeap& heap, const Player& player);
+
+public:
+    /**
+     * @brief Constructs an empty board.
+     *
+     * @param capacity The number of Players to keep (ie. the k in top-k)
+     * @param queues The number of sub-heaps (typically 2-4 per offering thread)
+     */
+    RelaxedTopK(const size_t& capacity, const size_t& queues);
+
+    /**
+     * @brief Offers a Player; safe to call from any number of threads at once.
+     *
+     * @param player A reference to the Player to be offered
+     * @return true if a sub-heap kept the Player, false otherwise
+     */
+    bool offer(const Player& player);
+
+    /**
+     * @brief Returns a lock-free lower bound on the exact cutoff (0 until a sub-heap is full).
+     */
+    size_t approximateCutoff() const;
+
+    /**
+     * @brief Merges the sub-heaps into the exact top-k.
+     *
+     * @pre No other thread is offering Players.
+     * @return The top <capacity> Players offered, in sorted (least to greatest) order
+     */
+    std::vector<Player> flush() const;
+};
+
+/**
+ * @brief Measurements of the relaxed top-k against the exact sharded approach.
+ */
+struct RelaxedStats {
+    double relaxedElapsed_; //Duration (ms) of ingesting & flushing via RelaxedTopK
+    double shardedElapsed_; //Duration (ms) of ingesting & merging via per-thread heaps
+    double meanRankError_; //Mean rank error of approximateCutoff() over the sampled rounds
+    size_t maxRankError_; //Worst rank error of approximateCutoff() over the sampled rounds
+};
+
+/**
+ * @brief Ranks a collection of Players by offering equal slices of it from several
+ *        threads at once into a shared `RelaxedTopK`, then flushing it.
+ *
+ * @param players The Players to be ranked
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param threads The number of threads offering Players
+ * @param queues_per_thread The number of sub-heaps per thread
+ * @return A RankingResult in which:
+ * - top_       -> Contains the top <capacity> Players in sorted (least to greatest) order
+ * - cutoffs_   -> Is empty
+ * - elapsed_   -> Contains the duration (ms) of the concurrent offers & the flush
+ */
+RankingResult rankRelaxed(const std::vector<Player>& players, const size_t& capacity, const unsigned& threads, const size_t& queues_per_thread = 2);
+
+/**
+ * @brief The exact sharded approach: each thread runs the `rankIncoming()` heap
+ *        over its own slice, & the per-thread heaps are merged at the end.
+ *
+ * @param players The Players to be ranked
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param threads The number of threads (& so shards)
+ * @return A RankingResult as for `rankRelaxed()`
+ */
+RankingResult rankSharded(const std::vector<Player>& players, const size_t& capacity, const unsigned& threads);
+
+/**
+ * @brief Measures the throughput of `rankRelaxed()` against `rankSharded()`, & the rank
+ *        error of the relaxed in-flight cutoff.
+ *
+ * The Players are ingested in <rounds> equal rounds. After each round, the rank of
+ * approximateCutoff() among the Players offered so far (ie. one plus the number of
+ * them at a strictly higher level) is compared against k, the rank of the exact cutoff.
+ *
+ * @param players The Players to be ranked
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param threads The number of threads offering Players
+ * @param rounds The number of points at which to sample the rank error
+ * @return The measured RelaxedStats
+ */
+RelaxedStats measureRelaxed(const std::vector<Player>& players, const size_t& capacity, const unsigned& threads, const size_t& rounds = 16);
+};
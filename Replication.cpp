@@ -0,0 +1,379 @@
+#include "Replication.hpp"
+#include "Snapshot.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+const uint32_t SNAPSHOT = 1;
+const uint32_t BATCH = 2;
+
+/**
+ * @brief The fixed header of every record.
+ */
+struct RecordHeader {
+    uint32_t type_;
+    uint32_t reserved_;
+    uint64_t first_; //The player count before the record's Players (BATCH) or of the state (SNAPSHOT)
+    uint64_t count_; //The number of Players in the record (BATCH)
+    uint64_t bytes_; //The length of the payload
+};
+
+/**
+ * @brief Fills a Unix domain socket address.
+ *
+ * @throws std::runtime_error If the path is too long.
+ */
+sockaddr_un addressOf(const std::string& path) {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path too long: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+/**
+ * @brief Reads exactly `size` bytes.
+ *
+ * @return false if the peer closed before the first byte
+ * @throws std::runtime_error If the peer closes part-way through.
+ */
+bool receiveAll(const int& fd, char* data, size_t size) {
+    size_t received = 0;
+    while (received < size) {
+        ssize_t got = ::recv(fd, data + received, size - received, 0);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            if (received == 0) {
+                return false;
+            }
+            throw std::runtime_error("Truncated replication record");
+        }
+        received += static_cast<size_t>(got);
+    }
+    return true;
+}
+};
+
+namespace Replication {
+/**
+ * @brief Starts a primary listening on a Unix domain socket.
+ *
+ * @param path The socket path (replaced if it exists)
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param batch_size The number of Players per BATCH record
+ * @param max_backlog The unsent bytes beyond which a stalled standby is resynced
+ *        with a SNAPSHOT (best kept above the size of one)
+ *
+ * @throws std::runtime_error If the socket cannot be created.
+ */
+Primary::Primary(const std::string& path, const size_t& reporting_interval, const size_t& batch_size, const size_t& max_backlog)
+    : ranker_ { reporting_interval }
+    , path_ { path }
+    , listen_ { -1 }
+    , standby_ { -1 }
+    , pendingCount_ { 0 }
+    , batchSize_ { std::max<size_t>(batch_size, 1) }
+    , sent_ { 0 }
+    , maxBacklog_ { max_backlog }
+    , resyncs_ { 0 }
+{
+    sockaddr_un address = addressOf(path);
+    ::unlink(path.c_str());
+
+    listen_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_ < 0 || ::bind(listen_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listen_, 1) != 0) {
+        if (listen_ >= 0) {
+            ::close(listen_);
+        }
+        throw std::runtime_error("Cannot listen on " + path);
+    }
+    ::fcntl(listen_, F_SETFL, ::fcntl(listen_, F_GETFL) | O_NONBLOCK);
+}
+
+Primary::~Primary() {
+    if (standby_ >= 0) {
+        ::close(standby_);
+    }
+    ::close(listen_);
+    ::unlink(path_.c_str());
+}
+
+/**
+ * @brief Queues a record for the standby, replacing the whole records queued by a
+ *        SNAPSHOT should the backlog outgrow its bound, then sends what it can.
+ */
+void Primary::send(const uint32_t& type, const size_t& first, const size_t& count, const std::string& payload) {
+    enqueue(type, first, count, payload);
+
+    if (backlog_.size() - sent_ > maxBacklog_) {
+        //Keep the rest of a part-sent record (so the stream stays framed), drop the others
+        auto next = std::upper_bound(ends_.begin(), ends_.end(), sent_);
+        bool boundary = sent_ == 0 || (next != ends_.begin() && *(next - 1) == sent_);
+        size_t keep = boundary ? sent_ : *next;
+        backlog_.resize(keep);
+        ends_.erase(std::upper_bound(ends_.begin(), ends_.end(), keep), ends_.end());
+
+        //The snapshot already includes every Player dropped
+        enqueue(SNAPSHOT, ranker_.playerCount(), 0, ranker_.serialize());
+        resyncs_++;
+    }
+    drain();
+}
+
+/**
+ * @brief Appends a record to the backlog.
+ */
+void Primary::enqueue(const uint32_t& type, const size_t& first, const size_t& count, const std::string& payload) {
+    RecordHeader header { type, 0, first, count, payload.size() };
+    backlog_.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    backlog_ += payload;
+    ends_.push_back(backlog_.size());
+}
+
+/**
+ * @brief Sends as much of the backlog as the socket accepts without blocking,
+ *        dropping the standby should it have gone.
+ */
+void Primary::drain() {
+    while (standby_ >= 0 && sent_ < backlog_.size()) {
+        ssize_t written = ::send(standby_, backlog_.data() + sent_, backlog_.size() - sent_, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (written <= 0) {
+            ::close(standby_);
+            standby_ = -1;
+        } else {
+            sent_ += static_cast<size_t>(written);
+        }
+    }
+
+    //Discard the records sent once they are the bulk of the buffer (or all of it),
+    //so that backlog_ always begins at a record
+    auto done = std::upper_bound(ends_.begin(), ends_.end(), sent_);
+    size_t cut = done == ends_.begin() ? 0 : *(done - 1);
+    if (standby_ < 0 || sent_ == backlog_.size()) {
+        backlog_.clear();
+        ends_.clear();
+        sent_ = 0;
+    } else if (cut > backlog_.size() / 2) {
+        backlog_.erase(0, cut);
+        ends_.erase(ends_.begin(), done);
+        for (size_t& end : ends_) {
+            end -= cut;
+        }
+        sent_ -= cut;
+    }
+}
+
+/**
+ * @brief Accepts a waiting standby (sending it a SNAPSHOT), or ships the pending batch.
+ */
+void Primary::ship() {
+    if (standby_ < 0) {
+        standby_ = ::accept(listen_, nullptr, nullptr);
+        if (standby_ >= 0) {
+            //The snapshot already includes the pending Players
+            ::fcntl(standby_, F_SETFL, ::fcntl(standby_, F_GETFL) | O_NONBLOCK);
+            send(SNAPSHOT, ranker_.playerCount(), 0, ranker_.serialize());
+        }
+    } else if (pendingCount_ > 0) {
+        send(BATCH, ranker_.playerCount() - pendingCount_, pendingCount_, pending_);
+    } else {
+        drain();
+    }
+
+    pending_.clear();
+    pendingCount_ = 0;
+}
+
+/**
+ * @brief Offers the next Player of the stream, shipping a batch once full.
+ *
+ * @param player A reference to the Player to be offered
+ * @return true if the Player was kept, false otherwise
+ */
+bool Primary::offer(const Player& player) {
+    bool kept = ranker_.offer(player);
+
+    Snapshot::encode(pending_, player);
+    pendingCount_++;
+
+    if (pendingCount_ >= batchSize_) {
+        ship();
+    }
+    return kept;
+}
+
+/**
+ * @brief Ships any pending Players now (eg. at the end of a stream), sending as
+ *        much of the backlog as the socket accepts without blocking.
+ *
+ * @return The number of bytes still queued for the standby
+ */
+size_t Primary::flush() {
+    ship();
+    return backlog_.size() - sent_;
+}
+
+/**
+ * @brief Returns whether a standby is connected.
+ */
+bool Primary::hasStandby() const {
+    return standby_ >= 0;
+}
+
+/**
+ * @brief Returns the number of times a stalled standby was resynced with a SNAPSHOT.
+ */
+size_t Primary::resyncs() const {
+    return resyncs_;
+}
+
+/**
+ * @brief Returns the live ranker.
+ */
+const Online::StreamRanker& Primary::ranker() const {
+    return ranker_;
+}
+
+/**
+ * @brief Connects to a primary.
+ *
+ * @param path The socket path the primary listens on
+ *
+ * @throws std::runtime_error If the primary cannot be reached.
+ */
+Standby::Standby(const std::string& path)
+    : fd_ { -1 }
+    , records_ { 0 }
+{
+    sockaddr_un address = addressOf(path);
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0 || ::connect(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        throw std::runtime_error("Cannot reach primary at " + path);
+    }
+}
+
+Standby::~Standby() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+/**
+ * @brief Receives & applies one record, blocking until it arrives.
+ *
+ * @return true if a record was applied, false if the primary has gone
+ *
+ * @throws std::runtime_error If a record is malformed (or its payload larger than
+ *         MAX_PAYLOAD) or a batch is missing.
+ */
+bool Standby::receive() {
+    if (fd_ < 0) {
+        return false;
+    }
+
+    RecordHeader header;
+    std::string payload;
+    if (!receiveAll(fd_, reinterpret_cast<char*>(&header), sizeof(header))) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    if (header.bytes_ > MAX_PAYLOAD) {
+        throw std::runtime_error("Replication record of " + std::to_string(header.bytes_) + " bytes exceeds the limit");
+    }
+    payload.resize(header.bytes_);
+    if (header.bytes_ > 0 && !receiveAll(fd_, &payload[0], payload.size())) {
+        throw std::runtime_error("Truncated replication record");
+    }
+
+    if (header.type_ == SNAPSHOT) {
+        ranker_ = Online::StreamRanker::deserialize(payload);
+    } else if (header.type_ == BATCH) {
+        if (!ranker_) {
+            throw std::runtime_error("Replication batch before snapshot");
+        }
+        if (header.first_ != ranker_->playerCount()) {
+            throw std::runtime_error("Replication gap: expected player " + std::to_string(ranker_->playerCount())
+                + " but received " + std::to_string(header.first_));
+        }
+
+        size_t pos = 0;
+        Player player;
+        for (uint64_t i = 0; i < header.count_; ++i) {
+            if (!Snapshot::tryDecode(payload, pos, player)) {
+                throw std::runtime_error("Truncated replication record");
+            }
+            ranker_->offer(player);
+        }
+    } else {
+        throw std::runtime_error("Unknown replication record type " + std::to_string(header.type_));
+    }
+
+    records_++;
+    return true;
+}
+
+/**
+ * @brief Applies records until the primary goes (eg. dies).
+ *
+ * @return The number of records applied in total
+ */
+size_t Standby::follow() {
+    while (receive()) {
+    }
+    return records_;
+}
+
+/**
+ * @brief Returns whether a SNAPSHOT has been received (ie. whether there is a ranker).
+ */
+bool Standby::ready() const {
+    return ranker_.has_value();
+}
+
+/**
+ * @brief Returns the replicated ranker.
+ *
+ * @pre ready()
+ */
+const Online::StreamRanker& Standby::ranker() const {
+    return *ranker_;
+}
+
+/**
+ * @brief Fails over: hands over the replicated ranker, to continue ingestion from
+ *        the Player after its playerCount().
+ *
+ * @throws std::runtime_error If no SNAPSHOT was received.
+ */
+Online::StreamRanker Standby::promote() {
+    if (!ranker_) {
+        throw std::runtime_error("Cannot promote a standby which has no snapshot");
+    }
+    Online::StreamRanker ranker = std::move(*ranker_);
+    ranker_.reset();
+    return ranker;
+}
+};
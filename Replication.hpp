@@ -0,0 +1,180 @@
+#pragma once
+
+#include "StreamRanker.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Primary/standby replication of an online ranker over a Unix domain socket.
+ *
+ * The primary ships records to (at most one) standby over a stream socket. Each record
+ * is a fixed header {type, first player count, player count, payload bytes} & a payload:
+ * - SNAPSHOT: the primary's full `StreamRanker` state, sent when a standby connects.
+ * - BATCH: the next <batch_size> Players offered, each encoded by `Snapshot::encode()`
+ *   (level & id, 8 bytes each, name length, 4 bytes, & name bytes).
+ *
+ * The standby applies each BATCH by offering its Players to its own StreamRanker,
+ * so it holds the same leaderboard as the primary as of the last batch shipped.
+ *
+ * The primary never blocks on the standby: records are queued in a backlog which is
+ * sent as far as the (non-blocking) socket accepts. Should a stalled standby let the
+ * backlog grow past its bound, the whole records queued are replaced by a single
+ * SNAPSHOT, which resyncs the standby once it catches up.
+ * When the primary dies, the standby reads end-of-stream & `promote()` hands over its
+ * ranker at once, with no replay.
+ */
+namespace Replication {
+/**
+ * @brief The primary side: ranks Players & ships them to a standby in batches.
+ */
+class Primary {
+private:
+    Online::StreamRanker ranker_; //The live ranker
+    std::string path_; //The socket path listened on
+    int listen_; //The listening socket (non-blocking)
+    int standby_; //The connected standby (non-blocking), or -1
+    std::string pending_; //The encoded Players not yet shipped
+    size_t pendingCount_; //The number of Players in pending_
+    size_t batchSize_; //The number of Players per BATCH record
+    std::string backlog_; //The records queued for the standby, from sent_ on not yet sent
+    size_t sent_; //The number of bytes of backlog_ already sent
+    std::vector<size_t> ends_; //The offset in backlog_ at which each queued record ends
+    size_t maxBacklog_; //The unsent bytes beyond which the standby is resynced
+    size_t resyncs_; //The number of times the standby was resynced
+
+    /**
+     * @brief Accepts a waiting standby (sending it a SNAPSHOT), or ships the pending batch.
+     */
+    void ship();
+
+    /**
+     * @brief Queues a record for the standby, replacing the whole records queued by a
+     *        SNAPSHOT should the backlog outgrow its bound, then sends what it can.
+     */
+    void send(const uint32_t& type, const size_t& first, const size_t& count, const std::string& payload);
+
+    /**
+     * @brief Appends a record to the backlog.
+     */
+    void enqueue(const uint32_t& type, const size_t& first, const size_t& count, const std::string& payload);
+
+    /**
+     * @brief Sends as much of the backlog as the socket accepts without blocking,
+     *        dropping the standby should it have gone.
+     */
+    void drain();
+
+public:
+    /**
+     * @brief Starts a primary listening on a Unix domain socket.
+     *
+     * @param path The socket path (replaced if it exists)
+     * @param reporting_interval The frequency at which to record cutoff levels
+     * @param batch_size The number of Players per BATCH record
+     * @param max_backlog The unsent bytes beyond which a stalled standby is resynced
+     *        with a SNAPSHOT (best kept above the size of one)
+     *
+     * @throws std::runtime_error If the socket cannot be created.
+     */
+    Primary(const std::string& path, const size_t& reporting_interval, const size_t& batch_size = 1024, const size_t& max_backlog = 64 << 20);
+    Primary(const Primary&) = delete;
+    Primary& operator=(const Primary&) = delete;
+    ~Primary();
+
+    /**
+     * @brief Offers the next Player of the stream, shipping a batch once full.
+     *
+     * @param player A reference to the Player to be offered
+     * @return true if the Player was kept, false otherwise
+     */
+    bool offer(const Player& player);
+
+    /**
+     * @brief Ships any pending Players now (eg. at the end of a stream), sending as
+     *        much of the backlog as the socket accepts without blocking.
+     *
+     * @return The number of bytes still queued for the standby
+     */
+    size_t flush();
+
+    /**
+     * @brief Returns whether a standby is connected.
+     */
+    bool hasStandby() const;
+
+    /**
+     * @brief Returns the number of times a stalled standby was resynced with a SNAPSHOT.
+     */
+    size_t resyncs() const;
+
+    /**
+     * @brief Returns the live ranker.
+     */
+    const Online::StreamRanker& ranker() const;
+};
+
+/**
+ * @brief The standby side: follows a primary, applying its records to its own ranker.
+ */
+class Standby {
+private:
+    static constexpr uint64_t MAX_PAYLOAD = 1ULL << 30; //The largest record payload accepted (1 GiB)
+
+    int fd_; //The socket connected to the primary, or -1 once it has closed
+    std::optional<Online::StreamRanker> ranker_; //The replicated ranker, once a SNAPSHOT arrives
+    size_t records_; //The number of records applied
+
+public:
+    /**
+     * @brief Connects to a primary.
+     *
+     * @param path The socket path the primary listens on
+     *
+     * @throws std::runtime_error If the primary cannot be reached.
+     */
+    Standby(const std::string& path);
+    Standby(const Standby&) = delete;
+    Standby& operator=(const Standby&) = delete;
+    ~Standby();
+
+    /**
+     * @brief Receives & applies one record, blocking until it arrives.
+     *
+     * @return true if a record was applied, false if the primary has gone
+     *
+     * @throws std::runtime_error If a record is malformed (or its payload larger than
+     *         MAX_PAYLOAD) or a batch is missing.
+     */
+    bool receive();
+
+    /**
+     * @brief Applies records until the primary goes (eg. dies).
+     *
+     * @return The number of records applied in total
+     */
+    size_t follow();
+
+    /**
+     * @brief Returns whether a SNAPSHOT has been received (ie. whether there is a ranker).
+     */
+    bool ready() const;
+
+    /**
+     * @brief Returns the replicated ranker.
+     *
+     * @pre ready()
+     */
+    const Online::StreamRanker& ranker() const;
+
+    /**
+     * @brief Fails over: hands over the replicated ranker, to continue ingestion from
+     *        the Player after its playerCount().
+     *
+     * @throws std::runtime_error If no SNAPSHOT was received.
+     */
+    Online::StreamRanker promote();
+};
+};
@@ -0,0 +1,304 @@
+#include "ShardedLeaderboard.hpp"
+#include "Hash.hpp"
+
+#include <stdexcept>
+
+/**
+ * @brief Places a shard's virtual nodes on the ring.
+ *
+ * @param shard The index of the shard
+ * @param vnodes The number of points to place for it
+ */
+void HashRing::add(const size_t& shard, const size_t& vnodes) {
+    for (size_t v = 0; v < vnodes; ++v) {
+        points_.emplace_back(Hash::mix64(Hash::mix64(shard) ^ v), shard);
+    }
+    std::sort(points_.begin(), points_.end());
+}
+
+/**
+ * @brief Returns the shard owning an id.
+ *
+ * @pre At least one shard has been added.
+ */
+size_t HashRing::owner(const size_t& id) const {
+    uint64_t hash = Hash::mix64(id);
+    auto it = std::lower_bound(points_.begin(), points_.end(), std::make_pair(hash, size_t(0)));
+    return it == points_.end() ? points_.front().second : it->second;
+}
+
+/**
+ * @brief Returns whether no shard has been added.
+ */
+bool HashRing::empty() const {
+    return points_.empty();
+}
+
+/**
+ * @brief Inserts a Player, or replaces the Player of the same id.
+ */
+void ShardRanker::upsert(const Player& player) {
+    auto it = players_.find(player.id_);
+    if (it != players_.end()) {
+        order_.erase({ it->second.level_, player.id_ });
+        it->second = player;
+    } else {
+        players_.emplace(player.id_, player);
+    }
+    order_.insert({ player.level_, player.id_ });
+}
+
+/**
+ * @brief Removes the Player of an id, returning whether there was one.
+ */
+bool ShardRanker::erase(const size_t& id) {
+    auto it = players_.find(id);
+    if (it == players_.end()) {
+        return false;
+    }
+    order_.erase({ it->second.level_, id });
+    players_.erase(it);
+    return true;
+}
+
+/**
+ * @brief Returns whether the shard holds a Player of an id.
+ */
+bool ShardRanker::contains(const size_t& id) const {
+    return players_.count(id) > 0;
+}
+
+/**
+ * @brief Returns the number of Players held.
+ */
+size_t ShardRanker::size() const {
+    return players_.size();
+}
+
+/**
+ * @brief Returns the (up to) k highest Players held, in descending order.
+ */
+std::vector<Player> ShardRanker::top(const size_t& k) const {
+    std::vector<Player> top;
+    top.reserve(std::min(k, order_.size()));
+    for (auto it = order_.rbegin(); it != order_.rend() && top.size() < k; ++it) {
+        top.push_back(players_.at(it->second));
+    }
+    return top;
+}
+
+/**
+ * @brief Starts the scan of `exportIf()` over from the first bucket (eg. for a new migration).
+ */
+void ShardRanker::restartExport() {
+    exportBucket_ = 0;
+    exportBuckets_ = players_.bucket_count();
+}
+
+/**
+ * @brief Inserts a batch of exported Players (a bulk import, for migration).
+ */
+void ShardRanker::importAll(const std::vector<Player>& players) {
+    //No reserve() per batch: it rehashes to the exact size asked, ie. on nearly every batch
+    for (const Player& player : players) {
+        upsert(player);
+    }
+}
+
+/**
+ * @brief Makes room for `count` Players, so that inserting them does not rehash.
+ */
+void ShardRanker::reserve(const size_t& count) {
+    players_.reserve(count);
+}
+
+/**
+ * @brief Constructs a leaderboard of `shards` empty shards.
+ *
+ * @param shards The initial number of shards (at least 1)
+ * @param vnodes The number of ring points per shard
+ */
+ShardedLeaderboard::ShardedLeaderboard(const size_t& shards, const size_t& vnodes)
+    : migrating_ { false }
+    , vnodes_ { std::max<size_t>(vnodes, 1) }
+{
+    for (size_t s = 0; s < std::max<size_t>(shards, 1); ++s) {
+        shards_.push_back(std::make_unique<ShardRanker>());
+        ring_.add(s, vnodes_);
+    }
+}
+
+/**
+ * @brief Inserts a Player, or replaces the Player of the same id.
+ */
+void ShardedLeaderboard::update(const Player& player) {
+    std::shared_lock<std::shared_mutex> layout(layout_);
+    ShardRanker& owner = *shards_[ring_.owner(player.id_)];
+
+    if (migrating_) {
+        ShardRanker& before = *shards_[previous_.owner(player.id_)];
+        if (&before != &owner) {
+            //Move the id on the spot (dropping its old Player) under both locks
+            std::scoped_lock locks(before.mutex_, owner.mutex_);
+            before.erase(player.id_);
+            owner.upsert(player);
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(owner.mutex_);
+    owner.upsert(player);
+}
+
+/**
+ * @brief Removes the Player of an id, returning whether there was one.
+ */
+bool ShardedLeaderboard::remove(const size_t& id) {
+    std::shared_lock<std::shared_mutex> layout(layout_);
+    ShardRanker& owner = *shards_[ring_.owner(id)];
+
+    if (migrating_) {
+        ShardRanker& before = *shards_[previous_.owner(id)];
+        if (&before != &owner) {
+            std::scoped_lock locks(before.mutex_, owner.mutex_);
+            bool removed = before.erase(id);
+            return owner.erase(id) || removed;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(owner.mutex_);
+    return owner.erase(id);
+}
+
+/**
+ * @brief Returns the k highest Players across every shard, in sorted (least to
+ *        greatest) order, merged from the shards' own top-ks.
+ */
+std::vector<Player> ShardedLeaderboard::top(const size_t& k) const {
+    std::shared_lock<std::shared_mutex> layout(layout_);
+
+    //Hold every shard (in index order) so that no id is seen mid-migration
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(shards_.size());
+    for (const std::unique_ptr<ShardRanker>& shard : shards_) {
+        locks.emplace_back(shard->mutex_);
+    }
+
+    std::vector<Player> top;
+    for (const std::unique_ptr<ShardRanker>& shard : shards_) {
+        std::vector<Player> shardTop = shard->top(k);
+        top.insert(top.end(), shardTop.begin(), shardTop.end());
+    }
+    locks.clear();
+
+    if (top.size() > k) {
+        std::nth_element(top.begin(), top.end() - k, top.end());
+        top.erase(top.begin(), top.end() - k);
+    }
+    std::sort(top.begin(), top.end());
+    return top;
+}
+
+/**
+ * @brief Returns the number of Players held across every shard.
+ */
+size_t ShardedLeaderboard::size() const {
+    size_t total = 0;
+    for (const size_t& count : shardSizes()) {
+        total += count;
+    }
+    return total;
+}
+
+/**
+ * @brief Returns the number of Players held by each shard.
+ */
+std::vector<size_t> ShardedLeaderboard::shardSizes() const {
+    std::shared_lock<std::shared_mutex> layout(layout_);
+    std::vector<std::unique_lock<std::mutex>> locks;
+    for (const std::unique_ptr<ShardRanker>& shard : shards_) {
+        locks.emplace_back(shard->mutex_);
+    }
+
+    std::vector<size_t> sizes;
+    for (const std::unique_ptr<ShardRanker>& shard : shards_) {
+        sizes.push_back(shard->size());
+    }
+    return sizes;
+}
+
+/**
+ * @brief Adds an empty shard, which takes over its share of the ids via `rebalance()`.
+ *
+ * @return The index of the new shard
+ * @throws std::runtime_error If a previous shard is still being rebalanced.
+ */
+size_t ShardedLeaderboard::addShard() {
+    std::unique_lock<std::shared_mutex> layout(layout_);
+    if (migrating_) {
+        throw std::runtime_error("Cannot add a shard while another is being rebalanced");
+    }
+
+    //Every old shard is scanned afresh for the ids the new one takes over
+    size_t players = 0;
+    for (const auto& existing : shards_) {
+        std::lock_guard<std::mutex> lock(existing->mutex_);
+        existing->restartExport();
+        players += existing->size();
+    }
+
+    //Size the new shard for its share up front, so that no batch rehashes it
+    size_t shard = shards_.size();
+    shards_.push_back(std::make_unique<ShardRanker>());
+    shards_.back()->reserve(players / (shard + 1) + players / (shard + 1) / 8);
+    previous_ = ring_;
+    ring_.add(shard, vnodes_);
+    migrating_ = true;
+    return shard;
+}
+
+/**
+ * @brief Moves (about) `batch_size` ids from each old shard to the shard being added.
+ *
+ * Each old shard's scan resumes where the previous call left it (see
+ * `ShardRanker::exportIf()`), so a call holds each lock for O(batch_size) work.
+ *
+ * @param batch_size The maximum number of Players moved per old shard
+ * @return The number of Players moved (0 once rebalancing is complete)
+ */
+size_t ShardedLeaderboard::rebalance(const size_t& batch_size) {
+    size_t moved = 0;
+    {
+        std::shared_lock<std::shared_mutex> layout(layout_);
+        if (!migrating_) {
+            return 0;
+        }
+
+        size_t target = shards_.size() - 1;
+        ShardRanker& destination = *shards_[target];
+        for (size_t s = 0; s < target; ++s) {
+            ShardRanker& source = *shards_[s];
+            std::scoped_lock locks(source.mutex_, destination.mutex_);
+            std::vector<Player> batch = source.exportIf([&](const size_t& id) {
+                return ring_.owner(id) == target;
+            }, std::max<size_t>(batch_size, 1));
+            destination.importAll(batch);
+            moved += batch.size();
+        }
+    }
+
+    //Nothing left to move, so every id is on its current owner
+    if (moved == 0) {
+        std::unique_lock<std::shared_mutex> layout(layout_);
+        migrating_ = false;
+    }
+    return moved;
+}
+
+/**
+ * @brief Returns whether a shard is still being rebalanced.
+ */
+bool ShardedLeaderboard::migrating() const {
+    std::shared_lock<std::shared_mutex> layout(layout_);
+    return migrating_;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A consistent-hash ring mapping Player ids onto shards.
+ *
+ * Each shard owns `vnodes` points on a 64-bit ring (hashes of its index & the point
+ * number), & an id belongs to the shard of the first point at or after `Hash::mix64(id)`.
+ * Adding a shard thus only takes over the ids just before its own points: about
+ * 1 / (shards + 1) of them, taken evenly from every other shard.
+ */
+class HashRing {
+private:
+    std::vector<std::pair<uint64_t, size_t>> points_; //(point, shard) pairs, sorted by point
+
+public:
+    /**
+     * @brief Places a shard's virtual nodes on the ring.
+     *
+     * @param shard The index of the shard
+     * @param vnodes The number of points to place for it
+     */
+    void add(const size_t& shard, const size_t& vnodes);
+
+    /**
+     * @brief Returns the shard owning an id.
+     *
+     * @pre At least one shard has been added.
+     */
+    size_t owner(const size_t& id) const;
+
+    /**
+     * @brief Returns whether no shard has been added.
+     */
+    bool empty() const;
+};
+
+/**
+ * @brief One shard of an updatable leaderboard: the latest Player of each id it owns,
+ *        indexed by id & ordered by (level, id).
+ */
+class ShardRanker {
+private:
+    std::unordered_map<size_t, Player> players_; //The latest Player of each id
+    std::set<std::pair<size_t, size_t>> order_; //(level, id) of every Player, ascending
+    size_t exportBucket_ { 0 }; //The next bucket of players_ for exportIf() to scan
+    size_t exportBuckets_ { 0 }; //The bucket count of players_ when exportBucket_ was set
+
+public:
+    mutable std::mutex mutex_; //Guards the members above (held by ShardedLeaderboard)
+
+    /**
+     * @brief Inserts a Player, or replaces the Player of the same id.
+     */
+    void upsert(const Player& player);
+
+    /**
+     * @brief Removes the Player of an id, returning whether there was one.
+     */
+    bool erase(const size_t& id);
+
+    /**
+     * @brief Returns whether the shard holds a Player of an id.
+     */
+    bool contains(const size_t& id) const;
+
+    /**
+     * @brief Returns the number of Players held.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the (up to) k highest Players held, in descending order.
+     */
+    std::vector<Player> top(const size_t& k) const;
+
+    /**
+     * @brief Removes & returns (about) `limit` Players whose ids satisfy `leaving(id)`
+     *        (a bulk export, for migration), or fewer once every id has been scanned.
+     *
+     * Each call resumes at the bucket of players_ where the previous one stopped, so a
+     * migration scans every id about once in total, however small its batches. Should
+     * players_ have rehashed in between (reordering its buckets), the scan restarts.
+     *
+     * @pre Since `restartExport()`, no id newly satisfying `leaving` was inserted.
+     */
+    template <typename Leaving>
+    std::vector<Player> exportIf(Leaving leaving, const size_t& limit) {
+        if (exportBuckets_ != players_.bucket_count()) {
+            exportBuckets_ = players_.bucket_count();
+            exportBucket_ = 0;
+        }
+
+        std::vector<Player> exported;
+        std::vector<size_t> ids;
+        for (; exportBucket_ < exportBuckets_ && exported.size() < limit; ++exportBucket_) {
+            //Collect the bucket's leaving ids first, as erasing would end its iteration
+            ids.clear();
+            for (auto it = players_.begin(exportBucket_); it != players_.end(exportBucket_); ++it) {
+                if (leaving(it->first)) {
+                    ids.push_back(it->first);
+                }
+            }
+            for (const size_t& id : ids) {
+                auto it = players_.find(id);
+                order_.erase({ it->second.level_, id });
+                exported.push_back(std::move(it->second));
+                players_.erase(it);
+            }
+        }
+        return exported;
+    }
+
+    /**
+     * @brief Starts the scan of `exportIf()` over from the first bucket (eg. for a new migration).
+     */
+    void restartExport();
+
+    /**
+     * @brief Inserts a batch of exported Players (a bulk import, for migration).
+     */
+    void importAll(const std::vector<Player>& players);
+
+    /**
+     * @brief Makes room for `count` Players, so that inserting them does not rehash.
+     */
+    void reserve(const size_t& count);
+};
+
+/**
+ * @brief A leaderboard sharded by consistent hashing of Player `id_`, in which each
+ *        id holds its latest Player, & to which shards can be added while it is in use.
+ *
+ * - `update()` & `remove()` lock only the shard owning the id.
+ * - `top()` locks every shard (in index order) & merges the shards' own top-ks,
+ *   so it always sees each id exactly once.
+ * - `addShard()` places a new shard on the ring at once, after which `rebalance()`
+ *   moves the ids it now owns from their old shards in batches (each batch under the
+ *   locks of its source & the new shard), while updates & queries continue. Until
+ *   then, an update of a not-yet-moved id moves it on the spot.
+ *
+ * Every method may be called from any number of threads at once.
+ */
+class ShardedLeaderboard {
+private:
+    std::vector<std::unique_ptr<ShardRanker>> shards_; //The shards, by index
+    HashRing ring_; //The current owner of every id
+    HashRing previous_; //The owner before the shard being rebalanced was added, if any
+    bool migrating_; //Whether ids may still be on their previous owner
+    size_t vnodes_; //The number of ring points per shard
+    mutable std::shared_mutex layout_; //Guards every member above (exclusively to add shards)
+
+public:
+    /**
+     * @brief Constructs a leaderboard of `shards` empty shards.
+     *
+     * @param shards The initial number of shards (at least 1)
+     * @param vnodes The number of ring points per shard
+     */
+    ShardedLeaderboard(const size_t& shards, const size_t& vnodes = 64);
+
+    /**
+     * @brief Inserts a Player, or replaces the Player of the same id.
+     */
+    void update(const Player& player);
+
+    /**
+     * @brief Removes the Player of an id, returning whether there was one.
+     */
+    bool remove(const size_t& id);
+
+    /**
+     * @brief Returns the k highest Players across every shard, in sorted (least to
+     *        greatest) order, merged from the shards' own top-ks.
+     */
+    std::vector<Player> top(const size_t& k) const;
+
+    /**
+     * @brief Returns the number of Players held across every shard.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the number of Players held by each shard.
+     */
+    std::vector<size_t> shardSizes() const;
+
+    /**
+     * @brief Adds an empty shard, which takes over its share of the ids via `rebalance()`.
+     *
+     * @return The index of the new shard
+     * @throws std::runtime_error If a previous shard is still being rebalanced.
+     */
+    size_t addShard();
+
+    /**
+     * @brief Moves (about) `batch_size` ids from each old shard to the shard being added.
+     *
+     * Each old shard's scan resumes where the previous call left it (see
+     * `ShardRanker::exportIf()`), so a call holds each lock for O(batch_size) work.
+     *
+     * @param batch_size The maximum number of Players moved per old shard
+     * @return The number of Players moved (0 once rebalancing is complete)
+     */
+    size_t rebalance(const size_t& batch_size = 1024);
+
+    /**
+     * @brief Returns whether a shard is still being rebalanced.
+     */
+    bool migrating() const;
+};
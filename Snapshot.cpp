@@ -0,0 +1,495 @@
+#include "Snapshot.hpp"
+#include "Hash.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+const char SNAPSHOT_MAGIC[8] = { 'P', 'L', 'S', 'N', 'A', 'P', '0', '1' };
+const char CACHE_MAGIC[8] = { 'P', 'L', 'B', 'C', 'A', 'C', '0', '1' };
+
+/**
+ * @brief The fixed-size header preceding the payload of every block.
+ */
+struct BlockHeader {
+    uint64_t bytes_; //The length of the payload, in bytes
+    uint64_t count_; //The number of Players encoded in the payload
+    uint64_t hash_; //The content hash of the payload
+    uint64_t maxLevel_; //The maximum level of any Player in the payload
+};
+
+/**
+ * @brief Decodes the Player at `offset` of a byte buffer, advancing `offset` past it.
+ *
+ * @throws std::runtime_error If the buffer ends part-way through the Player.
+ */
+Player decode(const std::string& buffer, size_t& offset) {
+    Player player;
+    if (!Snapshot::tryDecode(buffer, offset, player)) {
+        throw std::runtime_error("Truncated player record");
+    }
+    return player;
+}
+
+/**
+ * @brief Reads exactly `size` bytes from a file into `data`.
+ *
+ * @throws std::runtime_error If the file ends first.
+ */
+void readExactly(std::ifstream& in, void* data, const size_t& size) {
+    if (!in.read(static_cast<char*>(data), size)) {
+        throw std::runtime_error("Unexpected end of file");
+    }
+}
+
+/**
+ * @brief Opens a snapshot file & reads its header.
+ *
+ * @throws std::runtime_error If the file cannot be read or is not a snapshot.
+ */
+std::ifstream openSnapshot(const std::string& path, uint64_t& players, uint64_t& blocks) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open snapshot " + path);
+    }
+
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    readExactly(in, magic, sizeof(magic));
+    if (std::memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error(path + " is not a snapshot");
+    }
+    readExactly(in, &players, sizeof(players));
+    readExactly(in, &blocks, sizeof(blocks));
+    return in;
+}
+
+/**
+ * @brief Decodes every Player of a block payload.
+ */
+std::vector<Player> decodeBlock(const std::string& payload, const BlockHeader& header) {
+    std::vector<Player> players;
+    players.reserve(header.count_);
+    size_t offset = 0;
+    for (uint64_t i = 0; i < header.count_; ++i) {
+        players.push_back(decode(payload, offset));
+    }
+    return players;
+}
+
+const size_t MIN_CANDIDATES = 64; //The fewest candidates kept of a decoded block
+
+/**
+ * @brief Returns the number of candidates to keep of a block: about twice its
+ *        proportional share of the top-k (& at least MIN_CANDIDATES).
+ */
+size_t candidateDepth(const uint64_t& blockCount, const size_t& topCount, const uint64_t& count) {
+    uint64_t share = count == 0 ? 0 : (blockCount * topCount + count - 1) / count;
+    return static_cast<size_t>(std::min<uint64_t>(blockCount, std::max<uint64_t>(MIN_CANDIDATES, 2 * share)));
+}
+
+/**
+ * @brief Decodes a block of a snapshot file, keeping its best `depth` Players
+ *        (in descending order of level, then ascending order of id).
+ *
+ * @throws std::runtime_error If the block is corrupt.
+ */
+Snapshot::BlockCache::Summary summarize(std::ifstream& in, const std::string& path, const BlockHeader& header, const std::streamoff& offset, const size_t& depth) {
+    std::string payload(header.bytes_, '\0');
+    in.clear();
+    in.seekg(offset);
+    readExactly(in, &payload[0], payload.size());
+    if (Hash::bytes(payload.data(), payload.size()) != header.hash_) {
+        throw std::runtime_error(path + " has a corrupt block");
+    }
+
+    //Ties are broken by id, so that a deeper decode extends a shallower one
+    std::vector<Player> block = decodeBlock(payload, header);
+    size_t kept = std::min(block.size(), depth);
+    std::partial_sort(block.begin(), block.begin() + kept, block.end(), [](const Player& a, const Player& b) {
+        return a.level_ != b.level_ ? a.level_ > b.level_ : a.id_ < b.id_;
+    });
+    block.resize(kept);
+    return Snapshot::BlockCache::Summary { header.maxLevel_, header.count_, std::move(block) };
+}
+};
+
+namespace Snapshot {
+/**
+ * @brief Appends the encoding of a Player to a byte buffer.
+ */
+void encode(std::string& buffer, const Player& player) {
+    uint64_t level = player.level_;
+    uint64_t id = player.id_;
+    uint32_t length = static_cast<uint32_t>(player.name_.size());
+    buffer.append(reinterpret_cast<const char*>(&level), sizeof(level));
+    buffer.append(reinterpret_cast<const char*>(&id), sizeof(id));
+    buffer.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    buffer.append(player.name_);
+}
+
+/**
+ * @brief Decodes the Player at `offset` of a byte buffer, advancing `offset` past it,
+ *        unless the buffer ends part-way through it (eg. a partly read stream).
+ *
+ * @return true if a whole Player was decoded, false otherwise (leaving `offset` as is)
+ */
+bool tryDecode(const std::string& buffer, size_t& offset, Player& player) {
+    uint64_t level;
+    uint64_t id;
+    uint32_t length;
+    size_t header = sizeof(level) + sizeof(id) + sizeof(length);
+    if (buffer.size() < offset || buffer.size() - offset < header) {
+        return false;
+    }
+    std::memcpy(&level, buffer.data() + offset, sizeof(level));
+    std::memcpy(&id, buffer.data() + offset + sizeof(level), sizeof(id));
+    std::memcpy(&length, buffer.data() + offset + sizeof(level) + sizeof(id), sizeof(length));
+    if (buffer.size() - offset - header < length) {
+        return false;
+    }
+
+    player = Player(buffer.substr(offset + header, length), level, id);
+    offset += header + length;
+    return true;
+}
+
+/**
+ * @brief Writes a table of Players to a snapshot file.
+ *
+ * @param path The path of the file to be (over)written
+ * @param players The Players to be written, in order
+ * @param block_size The number of Players per block
+ *
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void write(const std::string& path, const std::vector<Player>& players, const size_t& block_size) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open snapshot " + path);
+    }
+
+    size_t blockSize = block_size == 0 ? 1 : block_size;
+    uint64_t count = players.size();
+    uint64_t blocks = (count + blockSize - 1) / blockSize;
+    out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(&blocks), sizeof(blocks));
+
+    std::string payload;
+    for (size_t begin = 0; begin < players.size(); begin += blockSize) {
+        size_t end = std::min(players.size(), begin + blockSize);
+        BlockHeader header { 0, end - begin, 0, 0 };
+
+        payload.clear();
+        for (size_t i = begin; i < end; ++i) {
+            encode(payload, players[i]);
+            header.maxLevel_ = std::max<uint64_t>(header.maxLevel_, players[i].level_);
+        }
+        header.bytes_ = payload.size();
+        header.hash_ = Hash::bytes(payload.data(), payload.size());
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(payload.data(), payload.size());
+    }
+
+    if (!out) {
+        throw std::runtime_error("Cannot write snapshot " + path);
+    }
+}
+
+/**
+ * @brief Reads every Player of a snapshot file, in order.
+ *
+ * @param path The path of the snapshot file
+ * @return The Players held in the file
+ *
+ * @throws std::runtime_error If the file cannot be read or is not a snapshot.
+ */
+std::vector<Player> read(const std::string& path) {
+    uint64_t count;
+    uint64_t blocks;
+    std::ifstream in = openSnapshot(path, count, blocks);
+
+    std::vector<Player> players;
+    players.reserve(count);
+    std::string payload;
+    for (uint64_t b = 0; b < blocks; ++b) {
+        BlockHeader header;
+        readExactly(in, &header, sizeof(header));
+        payload.resize(header.bytes_);
+        readExactly(in, &payload[0], payload.size());
+
+        std::vector<Player> block = decodeBlock(payload, header);
+        players.insert(players.end(), block.begin(), block.end());
+    }
+    return players;
+}
+
+/**
+ * @brief Constructs an empty cache.
+ */
+BlockCache::BlockCache()
+    : hits_ { 0 }
+    , misses_ { 0 }
+{
+}
+
+/**
+ * @brief Looks up the summary of a block holding at least `depth` candidates.
+ *
+ * @param hash The content hash of the block
+ * @param depth The number of candidates required (capped at the block's count)
+ * @return A pointer to the summary, or nullptr if it is not cached (deep enough)
+ */
+const BlockCache::Summary* BlockCache::find(const uint64_t& hash, const size_t& depth) {
+    auto found = entries_.find(hash);
+    if (found == entries_.end() || found->second.candidates_.size() < std::min<uint64_t>(depth, found->second.count_)) {
+        misses_++;
+        return nullptr;
+    }
+    hits_++;
+    return &found->second;
+}
+
+/**
+ * @brief Stores (or replaces) the summary of a block.
+ *
+ * @return A reference to the stored summary
+ */
+const BlockCache::Summary& BlockCache::store(const uint64_t& hash, Summary summary) {
+    Summary& stored = entries_[hash];
+    stored = std::move(summary);
+    return stored;
+}
+
+/**
+ * @brief Discards the summary of every block whose hash is not in `hashes`.
+ */
+void BlockCache::retain(const std::unordered_set<uint64_t>& hashes) {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (hashes.count(it->first) == 0) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief Writes the cache to a file, to be reused by a later run.
+ *
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void BlockCache::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open block cache " + path);
+    }
+
+    uint64_t count = entries_.size();
+    out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+    std::string payload;
+    for (const auto& entry : entries_) {
+        payload.clear();
+        for (const Player& candidate : entry.second.candidates_) {
+            encode(payload, candidate);
+        }
+        BlockHeader header { payload.size(), entry.second.count_, entry.first, entry.second.maxLevel_ };
+        uint64_t candidates = entry.second.candidates_.size();
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(&candidates), sizeof(candidates));
+        out.write(payload.data(), payload.size());
+    }
+
+    if (!out) {
+        throw std::runtime_error("Cannot write block cache " + path);
+    }
+}
+
+/**
+ * @brief Replaces the contents of the cache with those of a file written by `save()`.
+ *        A missing file leaves the cache empty.
+ *
+ * @throws std::runtime_error If the file exists but is not a block cache.
+ */
+void BlockCache::load(const std::string& path) {
+    entries_.clear();
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return;
+    }
+
+    char magic[sizeof(CACHE_MAGIC)];
+    uint64_t count;
+    readExactly(in, magic, sizeof(magic));
+    if (std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error(path + " is not a block cache");
+    }
+    readExactly(in, &count, sizeof(count));
+
+    std::string payload;
+    for (uint64_t e = 0; e < count; ++e) {
+        BlockHeader header;
+        uint64_t candidates;
+        readExactly(in, &header, sizeof(header));
+        readExactly(in, &candidates, sizeof(candidates));
+        payload.resize(header.bytes_);
+        readExactly(in, &payload[0], payload.size());
+
+        Summary summary { header.maxLevel_, header.count_, {} };
+        size_t offset = 0;
+        for (uint64_t c = 0; c < candidates; ++c) {
+            summary.candidates_.push_back(decode(payload, offset));
+        }
+        entries_[header.hash_] = std::move(summary);
+    }
+}
+
+/**
+ * @brief Returns the number of cached summaries.
+ */
+size_t BlockCache::size() const {
+    return entries_.size();
+}
+
+/**
+ * @brief Returns the number of lookups answered by the cache.
+ */
+size_t BlockCache::hits() const {
+    return hits_;
+}
+
+/**
+ * @brief Returns the number of lookups which required decoding a block.
+ */
+size_t BlockCache::misses() const {
+    return misses_;
+}
+};
+
+namespace Offline {
+/**
+ * @brief Selects & sorts the top 10% of the Players held in a snapshot file,
+ *        reusing cached summaries for blocks whose content is unchanged.
+ *
+ * @param path The path of the snapshot file
+ * @param cache The block cache to consult & update
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top 10% of players from the file in sorted order (ascending)
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the reading/selection/sorting operation
+ *
+ * @throws std::runtime_error If the file cannot be read or is not a snapshot.
+ */
+RankingResult rankSnapshot(const std::string& path, Snapshot::BlockCache& cache) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    uint64_t count;
+    uint64_t blocks;
+    std::ifstream in = openSnapshot(path, count, blocks);
+    size_t topCount = count / 10;
+
+    //Read only the block headers, remembering where each payload begins
+    std::vector<std::pair<BlockHeader, std::streamoff>> directory;
+    std::unordered_set<uint64_t> hashes;
+    directory.reserve(blocks);
+    for (uint64_t b = 0; b < blocks; ++b) {
+        BlockHeader header;
+        readExactly(in, &header, sizeof(header));
+        directory.emplace_back(header, static_cast<std::streamoff>(in.tellg()));
+        hashes.insert(header.hash_);
+        in.seekg(header.bytes_, std::ios::cur);
+    }
+
+    //Visit the most promising blocks first
+    std::sort(directory.begin(), directory.end(), [](const auto& a, const auto& b) {
+        return a.first.maxLevel_ > b.first.maxLevel_;
+    });
+
+    std::vector<Player> topPlayers;
+    topPlayers.reserve(topCount);
+
+    //Merges a block's candidates (descending) from `next` into the running top-k min-heap,
+    //returning whether every one was kept
+    auto merge = [&](const Snapshot::BlockCache::Summary& summary, size_t& next) {
+        for (; next < summary.candidates_.size(); ++next) {
+            const Player& candidate = summary.candidates_[next];
+            if (topPlayers.size() < topCount) {
+                topPlayers.push_back(candidate);
+                if (topPlayers.size() == topCount) {
+                    std::make_heap(topPlayers.begin(), topPlayers.end(), std::greater<Player>());
+                }
+            } else if (candidate > topPlayers.front()) {
+                Player target = candidate;
+                Online::replaceMin(topPlayers.begin(), topPlayers.end(), target);
+            } else {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    //Blocks whose every cached candidate was kept, but which hold more Players
+    struct Truncated {
+        const std::pair<BlockHeader, std::streamoff>* entry_;
+        const Snapshot::BlockCache::Summary* summary_;
+        size_t next_;
+    };
+    std::vector<Truncated> truncated;
+
+    for (const auto& entry : directory) {
+        const BlockHeader& header = entry.first;
+
+        //No Player of this (or any later) block can beat the cutoff
+        if (topCount == 0 || (topPlayers.size() == topCount && header.maxLevel_ <= topPlayers.front().level_)) {
+            break;
+        }
+
+        size_t depth = candidateDepth(header.count_, topCount, count);
+        const Snapshot::BlockCache::Summary* summary = cache.find(header.hash_, depth);
+        if (summary == nullptr) {
+            summary = &cache.store(header.hash_, summarize(in, path, header, entry.second, depth));
+        }
+
+        size_t next = 0;
+        if (merge(*summary, next) && summary->candidates_.size() < summary->count_) {
+            truncated.push_back(Truncated { &entry, summary, next });
+        }
+    }
+
+    //Decode truncated blocks deeper for as long as their unseen Players (none higher than
+    //their last candidate) might still beat the cutoff, which only rises meanwhile
+    while (!truncated.empty()) {
+        Truncated block = truncated.back();
+        truncated.pop_back();
+        size_t lowest = block.summary_->candidates_.back().level_;
+        if (topPlayers.size() == topCount && lowest <= topPlayers.front().level_) {
+            continue;
+        }
+
+        const BlockHeader& header = block.entry_->first;
+        size_t deeper = std::min<size_t>(header.count_, 2 * block.summary_->candidates_.size());
+        block.summary_ = &cache.store(header.hash_, summarize(in, path, header, block.entry_->second, deeper));
+        if (merge(*block.summary_, block.next_) && block.summary_->candidates_.size() < block.summary_->count_) {
+            truncated.push_back(block);
+        }
+    }
+
+    cache.retain(hashes);
+
+    //Sort the top players in ascending order
+    std::sort(topPlayers.begin(), topPlayers.end());
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //Return the Ranking Result object
+    return RankingResult(topPlayers, {}, elapsed);
+}
+};
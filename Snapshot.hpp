@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief A block-structured binary file format for snapshots of the player table.
+ *
+ * The file begins with a header (magic, player count, block count), followed by
+ * blocks of up to <block_size> Players. Every block begins with a fixed-size
+ * header holding its payload length, Player count, content hash & maximum level,
+ * so that a reader can skip (or prune) a block without decoding its Players.
+ *
+ * Each Player is encoded as its level & id (8 bytes each), name length (4 bytes)
+ * & name bytes, all little-endian as on the writing machine.
+ */
+namespace Snapshot {
+/**
+ * @brief Appends the encoding of a Player (its level, id, name length & name bytes,
+ *        as in a block) to a byte buffer.
+ */
+void encode(std::string& buffer, const Player& player);
+
+/**
+ * @brief Decodes the Player at `offset` of a byte buffer, advancing `offset` past it,
+ *        unless the buffer ends part-way through it (eg. a partly read stream).
+ *
+ * @return true if a whole Player was decoded, false otherwise (leaving `offset` as is)
+ */
+bool tryDecode(const std::string& buffer, size_t& offset, Player& player);
+
+/**
+ * @brief Writes a table of Players to a snapshot file.
+ *
+ * @param path The path of the file to be (over)written
+ * @param players The Players to be written, in order
+ * @param block_size The number of Players per block
+ *
+ * @throws std::runtime_error If the file cannot be written.
+ */
+void write(const std::string& path, const std::vector<Player>& players, const size_t& block_size = 4096);
+
+/**
+ * @brief Reads every Player of a snapshot file, in order.
+ *
+ * @param path The path of the snapshot file
+ * @return The Players held in the file
+ *
+ * @throws std::runtime_error If the file cannot be read or is not a snapshot.
+ */
+std::vector<Player> read(const std::string& path);
+
+/**
+ * @brief A cache of per-block summaries, keyed by the content hash of the block,
+ *        which persists between ranking runs (in memory, & optionally on disk).
+ *
+ * Each summary holds a block's Player count, maximum level, & its best Players to
+ * some depth (in descending order of level, then ascending order of id): about twice
+ * the block's proportional share of the top-k, or deeper should a ranking run have
+ * needed more of them. As a block's unseen Players are never above its last candidate,
+ * that is all `Offline::rankSnapshot()` needs from any block, & a block whose content
+ * is unchanged since a previous (equally deep) run is never decoded again.
+ */
+class BlockCache {
+public:
+    /**
+     * @brief The summary of a single block.
+     */
+    struct Summary {
+        uint64_t maxLevel_; //The maximum level of any Player in the block
+        uint64_t count_; //The number of Players in the block
+        std::vector<Player> candidates_; //The block's best Players to some depth, in descending order
+    };
+
+private:
+    std::unordered_map<uint64_t, Summary> entries_; //Summaries keyed by block content hash
+    size_t hits_; //The number of lookups answered by the cache
+    size_t misses_; //The number of lookups which required decoding a block
+
+public:
+    /**
+     * @brief Constructs an empty cache.
+     */
+    BlockCache();
+
+    /**
+     * @brief Looks up the summary of a block holding at least `depth` candidates.
+     *
+     * @param hash The content hash of the block
+     * @param depth The number of candidates required (capped at the block's count)
+     * @return A pointer to the summary, or nullptr if it is not cached (deep enough)
+     * @post The hit/miss counters are updated.
+     */
+    const Summary* find(const uint64_t& hash, const size_t& depth);
+
+    /**
+     * @brief Stores (or replaces) the summary of a block.
+     *
+     * @return A reference to the stored summary
+     */
+    const Summary& store(const uint64_t& hash, Summary summary);
+
+    /**
+     * @brief Discards the summary of every block whose hash is not in `hashes`
+     *        (ie. blocks which no longer appear in the latest snapshot).
+     */
+    void retain(const std::unordered_set<uint64_t>& hashes);
+
+    /**
+     * @brief Writes the cache to a file, to be reused by a later run.
+     *
+     * @throws std::runtime_error If the file cannot be written.
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Replaces the contents of the cache with those of a file written by `save()`.
+     *        A missing file leaves the cache empty.
+     *
+     * @throws std::runtime_error If the file exists but is not a block cache.
+     */
+    void load(const std::string& path);
+
+    /**
+     * @brief Returns the number of cached summaries.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns the number of lookups answered by / missed by the cache.
+     */
+    size_t hits() const;
+    size_t misses() const;
+};
+};
+
+namespace Offline {
+/**
+ * @brief Selects & sorts the top 10% of the Players held in a snapshot file,
+ *        reusing cached summaries for blocks whose content is unchanged.
+ *
+ * Blocks are visited in descending order of maximum level (read from the block
+ * headers alone), & the visit stops once the running cutoff is at least the
+ * maximum level of the next block. A visited block is only decoded if its
+ * content hash misses the cache; either way only its candidates are merged.
+ *
+ * A decoded block keeps about twice its proportional share of the top 10% as
+ * candidates (ie. 2 * count / 10, & at least MIN_CANDIDATES), rather than all of
+ * them, so the cache stays a small fraction of the snapshot. Should every cached
+ * candidate of a block make the top-k while its lowest candidate still beats the
+ * final cutoff (ie. the block is unusually strong), the block is decoded again to
+ * twice the depth & its merge resumes.
+ *
+ * @param path The path of the snapshot file
+ * @param cache The block cache to consult & update
+ * @return A Ranking Result object whose
+ * - top_ vector -> Contains the top 10% of players from the file in sorted order (ascending)
+ * - cutoffs_    -> Is empty
+ * - elapsed_    -> Contains the duration (ms) of the reading/selection/sorting operation
+ *
+ * @post The cache holds summaries for exactly the blocks of this snapshot
+ *       (those of blocks no longer present are discarded).
+ *
+ * @throws std::runtime_error If the file cannot be read or is not a snapshot.
+ */
+RankingResult rankSnapshot(const std::string& path, Snapshot::BlockCache& cache);
+};
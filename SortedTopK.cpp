@@ -0,0 +1,220 @@
+#include "SortedTopK.hpp"
+#include "Parallel.hpp"
+
+namespace Online {
+/**
+ * @brief Constructs an empty container holding at most `capacity` Players.
+ *
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ */
+SortedTopK::SortedTopK(const size_t& capacity)
+    : capacity_ { capacity }
+    , size_ { 0 }
+{
+}
+
+/**
+ * @brief Bulk-loads a container from Players sorted in ascending order by level
+ *        (eg. a restored snapshot), in O(N) time & with sequential writes.
+ *
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param sorted The Players to load, sorted in ascending order by level
+ */
+SortedTopK::SortedTopK(const size_t& capacity, const std::vector<Player>& sorted)
+    : SortedTopK(capacity)
+{
+    size_t fill = LEAF_CAPACITY * 3 / 4;
+    size_t begin = sorted.size() - std::min(capacity, sorted.size());
+
+    for (size_t i = begin; i < sorted.size(); i += fill) {
+        size_t end = std::min(sorted.size(), i + fill);
+        leaves_.push_back(Leaf { std::vector<Player>(sorted.begin() + i, sorted.begin() + end), 0 });
+        firsts_.push_back(sorted[i].level_);
+    }
+    size_ = sorted.size() - begin;
+}
+
+/**
+ * @brief Bulk-loads a container from Players in any order, sorting them
+ *        in parallel (see `Parallel::sort()`) before loading.
+ *
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param players The Players to load, in any order
+ * @param threads The number of threads to sort with (0 for the hardware concurrency)
+ * @return The loaded container
+ */
+SortedTopK SortedTopK::fromUnsorted(const size_t& capacity, std::vector<Player> players, unsigned threads) {
+    //Only the best `capacity` Players survive, so select them before sorting
+    if (players.size() > capacity) {
+        std::nth_element(players.begin(), players.end() - capacity, players.end());
+        players.erase(players.begin(), players.end() - capacity);
+    }
+
+    Parallel::sort(players.begin(), players.end(), std::less<Player>(), threads == 0 ? Parallel::defaultThreads() : threads);
+    return SortedTopK(capacity, players);
+}
+
+/**
+ * @brief Returns the index of the leaf into which a given level should be inserted
+ *        (ie. the last leaf whose minimum is at most `level`, or the first leaf).
+ */
+size_t SortedTopK::leafFor(const size_t& level) const {
+    size_t after = std::upper_bound(firsts_.begin(), firsts_.end(), level) - firsts_.begin();
+    return after == 0 ? 0 : after - 1;
+}
+
+/**
+ * @brief Removes the minimum Player, dropping the first leaf once it empties.
+ */
+void SortedTopK::popMin() {
+    Leaf& first = leaves_.front();
+    first.head_++;
+    size_--;
+
+    if (first.head_ == first.items_.size()) {
+        leaves_.erase(leaves_.begin());
+        firsts_.erase(firsts_.begin());
+    } else {
+        firsts_.front() = first.items_[first.head_].level_;
+    }
+}
+
+/**
+ * @brief Inserts a Player into its sorted position, splitting a full leaf.
+ */
+void SortedTopK::insert(const Player& player) {
+    size_++;
+    if (leaves_.empty()) {
+        leaves_.push_back(Leaf { { player }, 0 });
+        firsts_.push_back(player.level_);
+        return;
+    }
+
+    size_t i = leafFor(player.level_);
+    Leaf& leaf = leaves_[i];
+
+    //Reclaim the slots of evicted Players before shifting
+    if (leaf.head_ > 0) {
+        leaf.items_.erase(leaf.items_.begin(), leaf.items_.begin() + leaf.head_);
+        leaf.head_ = 0;
+    }
+
+    leaf.items_.insert(std::upper_bound(leaf.items_.begin(), leaf.items_.end(), player), player);
+    firsts_[i] = leaf.items_.front().level_;
+
+    //Split a full leaf in half, registering the upper half in the root
+    if (leaf.items_.size() > LEAF_CAPACITY) {
+        size_t half = leaf.items_.size() / 2;
+        Leaf upper { std::vector<Player>(leaf.items_.begin() + half, leaf.items_.end()), 0 };
+        leaf.items_.resize(half);
+        size_t upperFirst = upper.items_.front().level_;
+
+        leaves_.insert(leaves_.begin() + i + 1, std::move(upper));
+        firsts_.insert(firsts_.begin() + i + 1, upperFirst);
+    }
+}
+
+/**
+ * @brief Offers a Player, which is kept if the container has room or if
+ *        it outranks the current minimum (which is then evicted).
+ *
+ * @param player A reference to the Player to be offered
+ * @return true if the Player was kept, false otherwise
+ */
+bool SortedTopK::offer(const Player& player) {
+    if (size_ < capacity_) {
+        insert(player);
+        return true;
+    }
+    if (capacity_ == 0 || !(player > min())) {
+        return false;
+    }
+
+    popMin();
+    insert(player);
+    return true;
+}
+
+/**
+ * @brief Returns the lowest leveled Player kept (ie. the cutoff) in O(1).
+ *
+ * @pre The container is non-empty.
+ */
+const Player& SortedTopK::min() const {
+    const Leaf& first = leaves_.front();
+    return first.items_[first.head_];
+}
+
+/**
+ * @brief Returns the number of Players currently kept.
+ */
+size_t SortedTopK::size() const {
+    return size_;
+}
+
+/**
+ * @brief Returns whether the container holds `capacity` Players.
+ */
+bool SortedTopK::full() const {
+    return size_ == capacity_;
+}
+
+/**
+ * @brief Copies the Players kept, in sorted (least to greatest) order, in O(k).
+ */
+std::vector<Player> SortedTopK::snapshot() const {
+    std::vector<Player> players;
+    players.reserve(size_);
+    for (const Leaf& leaf : leaves_) {
+        players.insert(players.end(), leaf.items_.begin() + leaf.head_, leaf.items_.end());
+    }
+    return players;
+}
+
+/**
+ * @brief A version of `rankIncoming()` which keeps the running leaderboard in a
+ *        `SortedTopK` rather than a heap, so that no sort is needed to publish it.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncomingSorted(PlayerStream& stream, const size_t& reporting_interval) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Creates a sorted container for the top players and a map for cutoffs
+    SortedTopK topPlayers(reporting_interval);
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t playerCount = 0;
+
+    //Process the stream until no players remain
+    while (stream.remaining() > 0) {
+        Player currentPlayer = stream.nextPlayer();
+        playerCount++;
+
+        topPlayers.offer(currentPlayer);
+
+        if (playerCount % reporting_interval == 0) {
+            cutoffs[playerCount] = topPlayers.min().level_;
+        }
+    }
+
+    // Record cutoff for total players if not already recorded
+    if (topPlayers.size() > 0 && cutoffs.find(playerCount) == cutoffs.end()) {
+        cutoffs[playerCount] = topPlayers.min().level_;
+    }
+
+    //Already sorted, so only a linear copy is needed
+    std::vector<Player> top = topPlayers.snapshot();
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //Return the Ranking Result object
+    return RankingResult(top, cutoffs, elapsed);
+}
+};
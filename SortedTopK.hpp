@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <vector>
+
+namespace Online {
+/**
+ * @brief A bounded top-k container of Players which is always kept in sorted
+ *        (least to greatest) order, so a snapshot is a linear copy rather than
+ *        the O(k log k) `std::sort` a heap requires.
+ *
+ * Players are held in a two-level B+tree: a root array of leaf minimums over
+ * sorted leaf arrays of up to LEAF_CAPACITY Players. The minimum (ie. the cutoff)
+ * is the first live Player of the first leaf, & is always available in O(1).
+ *
+ * - Insertion binary-searches the root, then the leaf, & shifts at most one
+ *   leaf's worth of Players (splitting the leaf in two when it is full).
+ * - Eviction of the minimum only advances the first leaf's start offset;
+ *   emptied leaves are dropped from the root.
+ *
+ * @example With a capacity of 3, offering levels 5, 1, 9, 7 leaves { 5, 7, 9 },
+ * & snapshot() copies them out in that order without sorting.
+ */
+class SortedTopK {
+private:
+    static constexpr size_t LEAF_CAPACITY = 256; //The maximum number of Players per leaf
+
+    /**
+     * @brief A sorted leaf array; its live Players are items_[head_, items_.size()).
+     */
+    struct Leaf {
+        std::vector<Player> items_;
+        size_t head_;
+    };
+
+    std::vector<Leaf> leaves_; //Leaves, in ascending order
+    std::vector<size_t> firsts_; //The minimum level of each leaf (the root of the tree)
+    size_t capacity_; //The maximum number of Players kept
+    size_t size_; //The number of Players currently kept
+
+    /**
+     * @brief Returns the index of the leaf into which a given level should be inserted.
+     */
+    size_t leafFor(const size_t& level) const;
+
+    /**
+     * @brief Removes the minimum Player.
+     */
+    void popMin();
+
+    /**
+     * @brief Inserts a Player into its sorted position, splitting a full leaf.
+     */
+    void insert(const Player& player);
+
+public:
+    /**
+     * @brief Constructs an empty container holding at most `capacity` Players.
+     *
+     * @param capacity The number of Players to keep (ie. the k in top-k)
+     */
+    SortedTopK(const size_t& capacity);
+
+    /**
+     * @brief Bulk-loads a container from Players sorted in ascending order by level
+     *        (eg. a restored snapshot), in O(N) time & with sequential writes.
+     *
+     * Leaves are filled to 3/4 of LEAF_CAPACITY, leaving room for later inserts
+     * before the first splits. Should there be more than `capacity` Players,
+     * only the best are kept.
+     *
+     * @param capacity The number of Players to keep (ie. the k in top-k)
+     * @param sorted The Players to load, sorted in ascending order by level
+     */
+    SortedTopK(const size_t& capacity, const std::vector<Player>& sorted);
+
+    /**
+     * @brief Bulk-loads a container from Players in any order, sorting them
+     *        in parallel (see `Parallel::sort()`) before loading.
+     *
+     * Only the best `capacity` Players are sorted: they are selected first in O(N).
+     *
+     * @param capacity The number of Players to keep (ie. the k in top-k)
+     * @param players The Players to load, in any order
+     * @param threads The number of threads to sort with (0 for the hardware concurrency)
+     * @return The loaded container
+     */
+    static SortedTopK fromUnsorted(const size_t& capacity, std::vector<Player> players, unsigned threads = 0);
+
+    /**
+     * @brief Offers a Player, which is kept if the container has room or if
+     *        it outranks the current minimum (which is then evicted).
+     *
+     * Performs in O(log k + LEAF_CAPACITY) time.
+     *
+     * @param player A reference to the Player to be offered
+     * @return true if the Player was kept, false otherwise
+     */
+    bool offer(const Player& player);
+
+    /**
+     * @brief Returns the lowest leveled Player kept (ie. the cutoff) in O(1).
+     *
+     * @pre The container is non-empty.
+     */
+    const Player& min() const;
+
+    /**
+     * @brief Returns the number of Players currently kept.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns whether the container holds `capacity` Players.
+     */
+    bool full() const;
+
+    /**
+     * @brief Copies the Players kept, in sorted (least to greatest) order, in O(k).
+     */
+    std::vector<Player> snapshot() const;
+};
+
+/**
+ * @brief A version of `rankIncoming()` which keeps the running leaderboard in a
+ *        `SortedTopK` rather than a heap, so that no sort is needed to publish it.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @return A RankingResult as for `rankIncoming()`
+ *
+ * @post All elements of the stream are read until there are none remaining.
+ */
+RankingResult rankIncomingSorted(PlayerStream& stream, const size_t& reporting_interval);
+};
@@ -0,0 +1,174 @@
+#include "StreamRanker.hpp"
+#include "Bytes.hpp"
+#include "Snapshot.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+const char MAGIC[8] = { 'P', 'L', 'R', 'N', 'K', 'R', '0', '1' };
+const char* const FORMAT = "ranker state"; //The format named in decoding errors
+};
+
+namespace Online {
+/**
+ * @brief Constructs a ranker with nothing offered yet.
+ *
+ * @param reporting_interval The frequency at which to record cutoff levels
+ *        (& the number of Players to keep)
+ */
+StreamRanker::StreamRanker(const size_t& reporting_interval)
+    : reporting_interval_ { reporting_interval }
+    , playerCount_ { 0 }
+{
+}
+
+/**
+ * @brief Offers the next Player of the stream, as one iteration of `rankIncoming()`.
+ *
+ * @param player A reference to the Player to be offered
+ * @return true if the Player was kept, false otherwise
+ */
+bool StreamRanker::offer(const Player& player) {
+    playerCount_++;
+    bool kept = false;
+
+    if (heap_.size() < reporting_interval_) {
+        heap_.push_back(player);
+        if (heap_.size() == reporting_interval_) {
+            std::make_heap(heap_.begin(), heap_.end(), std::greater<Player>());
+        }
+        kept = true;
+    } else if (player > heap_.front()) {
+        Player target = player;
+        replaceMin(heap_.begin(), heap_.end(), target);
+        kept = true;
+    }
+
+    if (playerCount_ % reporting_interval_ == 0) {
+        cutoffs_[playerCount_] = heap_.front().level_;
+    }
+    return kept;
+}
+
+/**
+ * @brief Returns the number of Players offered so far.
+ */
+size_t StreamRanker::playerCount() const {
+    return playerCount_;
+}
+
+/**
+ * @brief Returns the reporting interval (ie. the number of Players kept).
+ */
+size_t StreamRanker::reportingInterval() const {
+    return reporting_interval_;
+}
+
+/**
+ * @brief Returns the leaderboard so far, as `rankIncoming()` would had the stream
+ *        ended here (including the cutoff after ALL players offered).
+ *
+ * @return A RankingResult whose elapsed_ is 0
+ */
+RankingResult StreamRanker::result() const {
+    std::unordered_map<size_t, size_t> cutoffs = cutoffs_;
+    if (!heap_.empty() && cutoffs.find(playerCount_) == cutoffs.end()) {
+        cutoffs[playerCount_] = heap_.front().level_;
+    }
+
+    std::vector<Player> top = heap_;
+    std::sort(top.begin(), top.end());
+    return RankingResult(top, cutoffs, 0);
+}
+
+/**
+ * @brief Encodes the full state as bytes (little-endian as on this machine):
+ *        magic, interval, player count, the heap in heap order & the cutoffs.
+ */
+std::string StreamRanker::serialize() const {
+    std::string out;
+    serialize([&out](const std::string& piece) {
+        out += piece;
+        return true;
+    });
+    return out;
+}
+
+/**
+ * @brief Encodes the full state as `serialize()` does, but hands it to a sink in pieces
+ *        of about `piece_size` bytes instead of building it whole in memory.
+ *
+ * @param sink Called with each piece in order; returns false to stop (eg. a failed write)
+ * @param piece_size The size (bytes) at which a piece is handed over
+ * @return false if the sink stopped the encoding, true otherwise
+ */
+bool StreamRanker::serialize(const std::function<bool(const std::string&)>& sink, const size_t& piece_size) const {
+    std::string out(MAGIC, sizeof(MAGIC));
+    out.reserve(piece_size + 64);
+    Bytes::put<uint64_t>(out, reporting_interval_);
+    Bytes::put<uint64_t>(out, playerCount_);
+
+    Bytes::put<uint64_t>(out, heap_.size());
+    for (const Player& player : heap_) {
+        Snapshot::encode(out, player);
+        if (out.size() >= piece_size) {
+            if (!sink(out)) {
+                return false;
+            }
+            out.clear();
+        }
+    }
+
+    Bytes::put<uint64_t>(out, cutoffs_.size());
+    for (const auto& cutoff : cutoffs_) {
+        Bytes::put<uint64_t>(out, cutoff.first);
+        Bytes::put<uint64_t>(out, cutoff.second);
+        if (out.size() >= piece_size) {
+            if (!sink(out)) {
+                return false;
+            }
+            out.clear();
+        }
+    }
+    return out.empty() || sink(out);
+}
+
+/**
+ * @brief Decodes a state encoded by `serialize()`.
+ *
+ * @param bytes The encoded state
+ * @return The decoded ranker
+ *
+ * @throws std::runtime_error If the bytes are not a (complete) encoded state.
+ */
+StreamRanker StreamRanker::deserialize(const std::string& bytes) {
+    if (bytes.size() < sizeof(MAGIC) || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not an encoded ranker state");
+    }
+    size_t pos = sizeof(MAGIC);
+
+    StreamRanker ranker(Bytes::take<uint64_t>(bytes, pos, FORMAT));
+    ranker.playerCount_ = Bytes::take<uint64_t>(bytes, pos, FORMAT);
+
+    //The heap is stored in heap order, so it is restored without re-heapifying
+    uint64_t players = Bytes::take<uint64_t>(bytes, pos, FORMAT);
+    if (players > ranker.reporting_interval_) {
+        throw std::runtime_error("Corrupt ranker state");
+    }
+    ranker.heap_.resize(players);
+    for (Player& player : ranker.heap_) {
+        if (!Snapshot::tryDecode(bytes, pos, player)) {
+            throw std::runtime_error("Truncated ranker state");
+        }
+    }
+
+    uint64_t cutoffs = Bytes::take<uint64_t>(bytes, pos, FORMAT);
+    for (uint64_t i = 0; i < cutoffs; ++i) {
+        size_t count = Bytes::take<uint64_t>(bytes, pos, FORMAT);
+        ranker.cutoffs_[count] = Bytes::take<uint64_t>(bytes, pos, FORMAT);
+    }
+    return ranker;
+}
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Online {
+/**
+ * @brief The state of `rankIncoming()` as an object which is fed one Player at a time,
+ *        so that it can outlive a single stream: be replicated, checkpointed & restored.
+ *
+ * It holds exactly what `rankIncoming()` does (the heap maintained with `replaceMin()`,
+ * the cutoffs recorded at each milestone & the player count), so offering it every
+ * Player of a stream & calling `result()` yields the same leaderboard & cutoffs.
+ */
+class StreamRanker {
+private:
+    size_t reporting_interval_; //The leaderboard size & the frequency of recorded cutoffs
+    std::vector<Player> heap_; //The top players, a min-heap by level once full
+    std::unordered_map<size_t, size_t> cutoffs_; //The cutoff levels recorded at each milestone
+    size_t playerCount_; //The number of Players offered
+
+public:
+    /**
+     * @brief Constructs a ranker with nothing offered yet.
+     *
+     * @param reporting_interval The frequency at which to record cutoff levels
+     *        (& the number of Players to keep)
+     */
+    StreamRanker(const size_t& reporting_interval);
+
+    /**
+     * @brief Offers the next Player of the stream, as one iteration of `rankIncoming()`.
+     *
+     * @param player A reference to the Player to be offered
+     * @return true if the Player was kept, false otherwise
+     */
+    bool offer(const Player& player);
+
+    /**
+     * @brief Returns the number of Players offered so far.
+     */
+    size_t playerCount() const;
+
+    /**
+     * @brief Returns the reporting interval (ie. the number of Players kept).
+     */
+    size_t reportingInterval() const;
+
+    /**
+     * @brief Returns the leaderboard so far, as `rankIncoming()` would had the stream
+     *        ended here (including the cutoff after ALL players offered).
+     *
+     * @return A RankingResult whose elapsed_ is 0
+     */
+    RankingResult result() const;
+
+    /**
+     * @brief Encodes the full state as bytes (little-endian as on this machine).
+     */
+    std::string serialize() const;
+
+    /**
+     * @brief Encodes the full state as `serialize()` does, but hands it to a sink in pieces
+     *        of about `piece_size` bytes instead of building it whole in memory.
+     *
+     * @param sink Called with each piece in order; returns false to stop (eg. a failed write)
+     * @param piece_size The size (bytes) at which a piece is handed over
+     * @return false if the sink stopped the encoding, true otherwise
+     */
+    bool serialize(const std::function<bool(const std::string&)>& sink, const size_t& piece_size = 1 << 16) const;
+
+    /**
+     * @brief Decodes a state encoded by `serialize()`.
+     *
+     * @param bytes The encoded state
+     * @return The decoded ranker
+     *
+     * @throws std::runtime_error If the bytes are not a (complete) encoded state.
+     */
+    static StreamRanker deserialize(const std::string& bytes);
+};
+};
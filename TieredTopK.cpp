@@ -0,0 +1,497 @@
+#include "TieredTopK.hpp"
+#include "Snapshot.hpp"
+
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace Online {
+/**
+ * @brief Constructs an empty board, which creates its spill files as it needs them.
+ *
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param hot_capacity The maximum number of Players in the hot region (at least 2)
+ * @param path The path prefix of the spill files (<path>.0, <path>.1 ...), which are
+ *        removed with the board
+ */
+TieredTopK::TieredTopK(const size_t& capacity, const size_t& hot_capacity, const std::string& path)
+    : capacity_ { capacity }
+    , hotCapacity_ { std::max<size_t>(hot_capacity, 2) }
+    , size_ { 0 }
+    , boundary_ { std::numeric_limits<size_t>::max() }
+    , path_ { path }
+    , nextRun_ { 0 }
+    , spillBytes_ { 0 }
+    , spilled_ { 0 }
+    , refills_ { 0 }
+{
+}
+
+/**
+ * @brief Closes & removes the spill files.
+ */
+TieredTopK::~TieredTopK() {
+    for (Run& run : runs_) {
+        run.in_.close();
+        std::remove(run.path_.c_str());
+    }
+}
+
+/**
+ * @brief Returns the lowest Player not yet taken from a run (nullptr once it is
+ *        exhausted), reading its next chunk if need be.
+ */
+const Player* TieredTopK::peek(Run& run) {
+    while (run.head_ == run.pending_.size()) {
+        if (run.next_ == run.end_) {
+            if (!run.bytes_.empty()) {
+                throw std::runtime_error("Truncated player record in spill file " + run.path_);
+            }
+            return nullptr;
+        }
+
+        //Read the next chunk, & decode every whole Player buffered
+        size_t bytes = static_cast<size_t>(std::min<uint64_t>(RUN_CHUNK, run.end_ - run.next_));
+        size_t buffered = run.bytes_.size();
+        run.bytes_.resize(buffered + bytes);
+        if (!run.in_.read(&run.bytes_[buffered], bytes)) {
+            throw std::runtime_error("Cannot read spill file " + run.path_);
+        }
+        run.next_ += bytes;
+
+        run.pending_.clear();
+        run.head_ = 0;
+        size_t offset = 0;
+        Player player;
+        while (Snapshot::tryDecode(run.bytes_, offset, player)) {
+            run.pending_.push_back(std::move(player));
+        }
+        run.bytes_.erase(0, offset);
+    }
+    return &run.pending_[run.head_];
+}
+
+/**
+ * @brief Returns the tier of a run, by the number of its Players not yet taken.
+ */
+size_t TieredTopK::tierOf(const Run& run) const {
+    size_t tier = 0;
+    for (size_t bound = hotCapacity_ * FAN_IN; run.count_ - run.taken_ >= bound; bound *= FAN_IN) {
+        tier++;
+    }
+    return tier;
+}
+
+/**
+ * @brief Opens a run just written to a spill file for reading.
+ */
+void TieredTopK::addRun(const std::string& path, const uint64_t& bytes, const size_t& count) {
+    runs_.push_back(Run { path, std::ifstream(path, std::ios::binary), 0, bytes, count, 0, {}, {}, 0 });
+    if (!runs_.back().in_) {
+        throw std::runtime_error("Cannot read spill file " + path);
+    }
+    spillBytes_ += bytes;
+    spilled_ += count;
+}
+
+/**
+ * @brief Writes a sorted (ascending) collection of Players as a new run, then
+ *        merges runs as their tiers fill.
+ */
+void TieredTopK::writeRun(const std::vector<Player>& players) {
+    std::string buffer;
+    for (const Player& player : players) {
+        Snapshot::encode(buffer, player);
+    }
+
+    std::string path = path_ + "." + std::to_string(nextRun_++);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(buffer.data(), buffer.size());
+    out.close();
+    if (!out) {
+        //Not yet in runs_, so the destructor would not remove it
+        std::remove(path.c_str());
+        throw std::runtime_error("Cannot write spill file " + path);
+    }
+    addRun(path, buffer.size(), players.size());
+    compact();
+}
+
+/**
+ * @brief Takes Players from some runs (& the buffer, if `with_upper`) in ascending
+ *        order, calling `take(player)` for each until it returns false or none are
+ *        left, then removes the runs exhausted.
+ */
+void TieredTopK::merge(const std::vector<size_t>& sources, const bool& with_upper, const std::function<bool(Player&)>& take) {
+    size_t upperHead = 0;
+    if (with_upper) {
+        std::sort(upper_.begin(), upper_.end());
+    }
+
+    //A min-heap of the (level, source) of each source's lowest Player, where
+    //source runs_.size() is the buffer
+    std::vector<std::pair<size_t, size_t>> heads;
+    for (const size_t& r : sources) {
+        if (const Player* head = peek(runs_[r])) {
+            heads.emplace_back(head->level_, r);
+        }
+    }
+    if (with_upper && !upper_.empty()) {
+        heads.emplace_back(upper_.front().level_, runs_.size());
+    }
+    std::make_heap(heads.begin(), heads.end(), std::greater<std::pair<size_t, size_t>>());
+
+    while (!heads.empty()) {
+        std::pop_heap(heads.begin(), heads.end(), std::greater<std::pair<size_t, size_t>>());
+        size_t source = heads.back().second;
+        heads.pop_back();
+
+        Player player;
+        const Player* next = nullptr;
+        if (source == runs_.size()) {
+            player = std::move(upper_[upperHead++]);
+            next = upperHead < upper_.size() ? &upper_[upperHead] : nullptr;
+        } else {
+            Run& run = runs_[source];
+            player = std::move(run.pending_[run.head_++]);
+            run.taken_++;
+            next = peek(run);
+        }
+
+        if (next != nullptr) {
+            heads.emplace_back(next->level_, source);
+            std::push_heap(heads.begin(), heads.end(), std::greater<std::pair<size_t, size_t>>());
+        }
+        if (!take(player)) {
+            break;
+        }
+    }
+
+    //Drop what was taken, removing the files of exhausted runs
+    upper_.erase(upper_.begin(), upper_.begin() + upperHead);
+    std::vector<Run> remaining;
+    for (Run& run : runs_) {
+        if (run.taken_ < run.count_) {
+            remaining.push_back(std::move(run));
+        } else {
+            run.in_.close();
+            std::remove(run.path_.c_str());
+            spillBytes_ -= run.end_;
+        }
+    }
+    runs_.swap(remaining);
+}
+
+/**
+ * @brief Merges some runs into a single new run.
+ */
+void TieredTopK::mergeRuns(const std::vector<size_t>& sources) {
+    std::string path = path_ + "." + std::to_string(nextRun_++);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot create spill file " + path);
+    }
+
+    std::string buffer;
+    uint64_t bytes = 0;
+    size_t count = 0;
+    try {
+        merge(sources, false, [&](Player& player) {
+            Snapshot::encode(buffer, player);
+            count++;
+            if (buffer.size() >= RUN_CHUNK) {
+                out.write(buffer.data(), buffer.size());
+                bytes += buffer.size();
+                buffer.clear();
+            }
+            return true;
+        });
+    } catch (...) {
+        //A source run could not be read; the new run is not yet in runs_
+        out.close();
+        std::remove(path.c_str());
+        throw;
+    }
+    out.write(buffer.data(), buffer.size());
+    bytes += buffer.size();
+    out.close();
+    if (!out) {
+        //Not yet in runs_, so the destructor would not remove it
+        std::remove(path.c_str());
+        throw std::runtime_error("Cannot write spill file " + path);
+    }
+    addRun(path, bytes, count);
+}
+
+/**
+ * @brief Rewrites every run of which half has been taken, then merges the runs of
+ *        any tier holding FAN_IN of them, until none does.
+ */
+void TieredTopK::compact() {
+    for (size_t r = 0; r < runs_.size();) {
+        //mergeRuns() replaces the run at r by the one appended at the end
+        if (runs_[r].taken_ * 2 >= runs_[r].count_ && runs_[r].taken_ > 0) {
+            mergeRuns({ r });
+        } else {
+            ++r;
+        }
+    }
+
+    for (;;) {
+        std::vector<std::vector<size_t>> tiers;
+        for (size_t r = 0; r < runs_.size(); ++r) {
+            size_t tier = tierOf(runs_[r]);
+            tiers.resize(std::max(tiers.size(), tier + 1));
+            tiers[tier].push_back(r);
+        }
+        auto full = std::find_if(tiers.begin(), tiers.end(), [](const std::vector<size_t>& tier) {
+            return tier.size() >= FAN_IN;
+        });
+        if (full == tiers.end()) {
+            return;
+        }
+        mergeRuns(*full);
+    }
+}
+
+/**
+ * @brief Adds a Player while fewer than k are held.
+ */
+void TieredTopK::insert(const Player& player) {
+    if (player.level_ > boundary_) {
+        upper_.push_back(player);
+        if (upper_.size() >= hotCapacity_) {
+            flushUpper();
+        }
+        return;
+    }
+
+    hot_.push_back(player);
+    std::push_heap(hot_.begin(), hot_.end(), std::greater<Player>());
+    if (hot_.size() > hotCapacity_) {
+        spillHot();
+    }
+}
+
+/**
+ * @brief Writes the upper half of an overfull hot region as a run, lowering the boundary.
+ */
+void TieredTopK::spillHot() {
+    std::sort(hot_.begin(), hot_.end());
+    size_t half = hot_.size() / 2;
+    std::vector<Player> spill(hot_.begin() + half, hot_.end());
+    hot_.resize(half);
+    std::make_heap(hot_.begin(), hot_.end(), std::greater<Player>());
+
+    //Everything held outside the hot region is at least as high as the spilled half
+    boundary_ = spill.front().level_;
+    writeRun(spill);
+}
+
+/**
+ * @brief Writes the buffer as a run.
+ */
+void TieredTopK::flushUpper() {
+    std::vector<Player> batch;
+    batch.swap(upper_);
+    std::sort(batch.begin(), batch.end());
+    writeRun(batch);
+}
+
+/**
+ * @brief Refills the (empty) hot region with the lowest Players of the runs & buffer.
+ */
+void TieredTopK::refill() {
+    refills_++;
+    std::vector<size_t> sources(runs_.size());
+    std::iota(sources.begin(), sources.end(), 0);
+    merge(sources, true, [&](Player& player) {
+        boundary_ = player.level_;
+        hot_.push_back(std::move(player));
+        return hot_.size() < hotCapacity_;
+    });
+
+    //With nothing left outside the hot region, any Player may enter it
+    if (runs_.empty() && upper_.empty()) {
+        boundary_ = std::numeric_limits<size_t>::max();
+    }
+    std::make_heap(hot_.begin(), hot_.end(), std::greater<Player>());
+
+    //Reclaim the prefixes just taken
+    compact();
+}
+
+/**
+ * @brief Offers a Player, as one iteration of `rankIncoming()`.
+ *
+ * @param player A reference to the Player to be offered
+ * @return true if the Player was kept, false otherwise
+ *
+ * @throws std::runtime_error If a spill file cannot be written or read.
+ */
+bool TieredTopK::offer(const Player& player) {
+    if (capacity_ == 0) {
+        return false;
+    }
+    if (size_ < capacity_) {
+        insert(player);
+        size_++;
+        return true;
+    }
+    if (!(player > hot_.front())) {
+        return false;
+    }
+
+    //Most accepted Players land near the cutoff, & so only touch the hot heap
+    if (player.level_ <= boundary_) {
+        Player target = player;
+        replaceMin(hot_.begin(), hot_.end(), target);
+        return true;
+    }
+
+    std::pop_heap(hot_.begin(), hot_.end(), std::greater<Player>());
+    hot_.pop_back();
+    upper_.push_back(player);
+    if (upper_.size() >= hotCapacity_) {
+        flushUpper();
+    }
+    if (hot_.empty()) {
+        refill();
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the minimum level held (ie. the cutoff once full).
+ *
+ * @pre At least one Player is held.
+ */
+size_t TieredTopK::cutoff() const {
+    return hot_.front().level_;
+}
+
+/**
+ * @brief Returns the number of Players held.
+ */
+size_t TieredTopK::size() const {
+    return size_;
+}
+
+/**
+ * @brief Returns whether k Players are held.
+ */
+bool TieredTopK::full() const {
+    return size_ == capacity_;
+}
+
+/**
+ * @brief Returns the number of Players currently in memory (hot region & buffer).
+ */
+size_t TieredTopK::resident() const {
+    return hot_.size() + upper_.size();
+}
+
+/**
+ * @brief Returns the number of runs (ie. of spill files).
+ */
+size_t TieredTopK::runs() const {
+    return runs_.size();
+}
+
+/**
+ * @brief Returns the length of every spill file together, in bytes.
+ */
+uint64_t TieredTopK::spillBytes() const {
+    return spillBytes_;
+}
+
+/**
+ * @brief Returns the number of Players written to runs so far (including by merges).
+ */
+size_t TieredTopK::spilled() const {
+    return spilled_;
+}
+
+/**
+ * @brief Returns the number of times the hot region has been refilled from the runs.
+ */
+size_t TieredTopK::refills() const {
+    return refills_;
+}
+
+/**
+ * @brief Visits every Player held in sorted (least to greatest) order, emptying the board.
+ *
+ * @param visit Called with each Player in turn
+ */
+void TieredTopK::finalize(const std::function<void(const Player&)>& visit) {
+    //The hot region lies wholly below the runs & buffer
+    std::sort(hot_.begin(), hot_.end());
+    for (const Player& player : hot_) {
+        visit(player);
+    }
+    hot_.clear();
+
+    std::vector<size_t> sources(runs_.size());
+    std::iota(sources.begin(), sources.end(), 0);
+    merge(sources, true, [&](Player& player) {
+        visit(player);
+        return true;
+    });
+    size_ = 0;
+    boundary_ = std::numeric_limits<size_t>::max();
+}
+
+/**
+ * @brief A version of `rankIncoming()` which keeps the top <reporting_interval> Players
+ *        in a `TieredTopK`, so that only its hot region & buffer are held in memory
+ *        while reading the stream.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param hot_capacity The maximum number of Players in the hot region
+ * @param path The path prefix of the spill files (removed before returning)
+ * @return A RankingResult as for `rankIncoming()`. Note that top_ holds every Player
+ *         kept; for a k too large for memory, use `TieredTopK::finalize()` instead.
+ *
+ * @throws std::runtime_error If a spill file cannot be written or read.
+ * @post All elements of the stream are read until there are none remaining
+ *       (unless an exception is thrown).
+ */
+RankingResult rankIncomingTiered(PlayerStream& stream, const size_t& reporting_interval, const size_t& hot_capacity, const std::string& path) {
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    TieredTopK board(reporting_interval, hot_capacity, path);
+    std::unordered_map<size_t, size_t> cutoffs;
+    size_t playerCount = 0;
+
+    //Process the stream until no players remain
+    while (stream.remaining() > 0) {
+        board.offer(stream.nextPlayer());
+        playerCount++;
+
+        if (playerCount % reporting_interval == 0) {
+            cutoffs[playerCount] = board.cutoff();
+        }
+    }
+
+    // Record cutoff for total players if not already recorded
+    if (board.size() > 0 && cutoffs.find(playerCount) == cutoffs.end()) {
+        cutoffs[playerCount] = board.cutoff();
+    }
+
+    std::vector<Player> topPlayers;
+    topPlayers.reserve(board.size());
+    board.finalize([&](const Player& player) {
+        topPlayers.push_back(player);
+    });
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return RankingResult(topPlayers, cutoffs, elapsed);
+}
+};
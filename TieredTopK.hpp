@@ -0,0 +1,229 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Online {
+/**
+ * @brief An online top-k for very large k (eg. the top 50M of a season), of which only
+ *        the region near the cutoff is held in memory & the upper ranks are kept on disk.
+ *
+ * The k Players held are split at a boundary level:
+ * - The hot region (at most `hot_capacity` Players at or below the boundary) is a
+ *   min-heap in memory, so the cutoff is its minimum & an accepted Player below the
+ *   boundary is handled by `replaceMin()`, exactly as in `rankIncoming()`.
+ * - Players above the boundary are buffered in memory & written, once the buffer holds
+ *   `hot_capacity` of them, as a sorted run to a spill file of its own. They are never
+ *   evicted from disk: every eviction is of the hot region's minimum.
+ *
+ * Once evictions empty the hot region, it is refilled with the lowest `hot_capacity`
+ * Players of the runs & buffer (merging the low ends of the runs), & the boundary rises
+ * to the highest level taken. Runs are read sequentially from their low ends.
+ *
+ * Runs are merged size-tiered: a run of n Players not yet taken is in tier
+ * floor(log_FAN_IN(n / hot_capacity)), & whenever a tier holds FAN_IN runs they are
+ * merged into one (of the next tier). So each Player is rewritten O(log(k / hot_capacity))
+ * times, & there are at most about FAN_IN runs per tier. Disk space is reclaimed as runs
+ * are consumed: a run's file is removed once it is exhausted (or merged), & a run of
+ * which half has been taken is rewritten without its taken prefix (which rewrites each
+ * Player at most about once more in total).
+ *
+ * So most offers touch only the hot heap, while `finalize()` still yields the exact top-k.
+ * Memory use is about 2 * hot_capacity Players plus a read buffer of RUN_CHUNK bytes per run.
+ */
+class TieredTopK {
+public:
+    static constexpr size_t FAN_IN = 4; //The number of runs of one tier merged into one
+    static constexpr size_t RUN_CHUNK = 1 << 16; //The number of bytes read from a run at once
+
+private:
+    /**
+     * @brief A sorted (ascending) run of Players in a spill file, & its read position.
+     */
+    struct Run {
+        std::string path_; //The path of the run's file
+        std::ifstream in_; //The run's file, read sequentially
+        uint64_t next_; //The file offset of the first byte not yet read
+        uint64_t end_; //The length of the file
+        size_t count_; //The number of Players written to the run
+        size_t taken_; //The number of Players taken from the run
+        std::string bytes_; //Bytes read but not yet decoded
+        std::vector<Player> pending_; //Players decoded but not yet taken
+        size_t head_; //The index in pending_ of the lowest Player not yet taken
+    };
+
+    size_t capacity_; //The number of Players to keep (ie. the k in top-k)
+    size_t hotCapacity_; //The maximum number of Players in the hot region
+    size_t size_; //The number of Players held (in every region)
+    size_t boundary_; //The level at or above which Players are held outside the hot region
+    std::vector<Player> hot_; //The hot region, a min-heap by level
+    std::vector<Player> upper_; //Players above the boundary not yet written to a run
+    std::vector<Run> runs_; //The runs, each holding Players not yet taken
+    std::string path_; //The path prefix of the spill files
+    size_t nextRun_; //The number of the next spill file (ie. <path_>.<nextRun_>)
+    uint64_t spillBytes_; //The length of every spill file together
+    size_t spilled_; //The number of Players written to runs (including by merges)
+    size_t refills_; //The number of times the hot region has been refilled
+
+    /**
+     * @brief Returns the lowest Player not yet taken from a run (nullptr once it is
+     *        exhausted), reading its next chunk if need be.
+     */
+    const Player* peek(Run& run);
+
+    /**
+     * @brief Returns the tier of a run, by the number of its Players not yet taken.
+     */
+    size_t tierOf(const Run& run) const;
+
+    /**
+     * @brief Opens a run just written to a spill file for reading.
+     */
+    void addRun(const std::string& path, const uint64_t& bytes, const size_t& count);
+
+    /**
+     * @brief Writes a sorted (ascending) collection of Players as a new run, then
+     *        merges runs as their tiers fill.
+     */
+    void writeRun(const std::vector<Player>& players);
+
+    /**
+     * @brief Takes Players from some runs (& the buffer, if `with_upper`) in ascending
+     *        order, calling `take(player)` for each until it returns false or none are
+     *        left, then removes the runs exhausted.
+     */
+    void merge(const std::vector<size_t>& sources, const bool& with_upper, const std::function<bool(Player&)>& take);
+
+    /**
+     * @brief Merges some runs into a single new run.
+     */
+    void mergeRuns(const std::vector<size_t>& sources);
+
+    /**
+     * @brief Rewrites every run of which half has been taken, then merges the runs of
+     *        any tier holding FAN_IN of them, until none does.
+     */
+    void compact();
+
+    /**
+     * @brief Adds a Player while fewer than k are held.
+     */
+    void insert(const Player& player);
+
+    /**
+     * @brief Writes the upper half of an overfull hot region as a run, lowering the boundary.
+     */
+    void spillHot();
+
+    /**
+     * @brief Writes the buffer as a run.
+     */
+    void flushUpper();
+
+    /**
+     * @brief Refills the (empty) hot region with the lowest Players of the runs & buffer.
+     */
+    void refill();
+
+public:
+    /**
+     * @brief Constructs an empty board, which creates its spill files as it needs them.
+     *
+     * @param capacity The number of Players to keep (ie. the k in top-k)
+     * @param hot_capacity The maximum number of Players in the hot region (at least 2)
+     * @param path The path prefix of the spill files (<path>.0, <path>.1 ...), which are
+     *        removed with the board
+     */
+    TieredTopK(const size_t& capacity, const size_t& hot_capacity, const std::string& path);
+
+    TieredTopK(const TieredTopK&) = delete;
+    TieredTopK& operator=(const TieredTopK&) = delete;
+
+    /**
+     * @brief Closes & removes the spill files.
+     */
+    ~TieredTopK();
+
+    /**
+     * @brief Offers a Player, as one iteration of `rankIncoming()`.
+     *
+     * @param player A reference to the Player to be offered
+     * @return true if the Player was kept, false otherwise
+     *
+     * @throws std::runtime_error If a spill file cannot be written or read.
+     */
+    bool offer(const Player& player);
+
+    /**
+     * @brief Returns the minimum level held (ie. the cutoff once full).
+     *
+     * @pre At least one Player is held.
+     */
+    size_t cutoff() const;
+
+    /**
+     * @brief Returns the number of Players held.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Returns whether k Players are held.
+     */
+    bool full() const;
+
+    /**
+     * @brief Returns the number of Players currently in memory (hot region & buffer).
+     */
+    size_t resident() const;
+
+    /**
+     * @brief Returns the number of runs (ie. of spill files).
+     */
+    size_t runs() const;
+
+    /**
+     * @brief Returns the length of every spill file together, in bytes.
+     */
+    uint64_t spillBytes() const;
+
+    /**
+     * @brief Returns the number of Players written to runs so far (including by merges).
+     */
+    size_t spilled() const;
+
+    /**
+     * @brief Returns the number of times the hot region has been refilled from the runs.
+     */
+    size_t refills() const;
+
+    /**
+     * @brief Visits every Player held in sorted (least to greatest) order, emptying the board.
+     *
+     * @param visit Called with each Player in turn
+     */
+    void finalize(const std::function<void(const Player&)>& visit);
+};
+
+/**
+ * @brief A version of `rankIncoming()` which keeps the top <reporting_interval> Players
+ *        in a `TieredTopK`, so that only its hot region & buffer are held in memory
+ *        while reading the stream.
+ *
+ * @param stream A stream providing Player objects
+ * @param reporting_interval The frequency at which to record cutoff levels
+ * @param hot_capacity The maximum number of Players in the hot region
+ * @param path The path prefix of the spill files (removed before returning)
+ * @return A RankingResult as for `rankIncoming()`. Note that top_ holds every Player
+ *         kept; for a k too large for memory, use `TieredTopK::finalize()` instead.
+ *
+ * @throws std::runtime_error If a spill file cannot be written or read.
+ * @post All elements of the stream are read until there are none remaining
+ *       (unless an exception is thrown).
+ */
+RankingResult rankIncomingTiered(PlayerStream& stream, const size_t& reporting_interval, const size_t& hot_capacity, const std::string& path);
+};
@@ -0,0 +1,284 @@
+#include "VersionedRanker.hpp"
+
+#include <stdexcept>
+
+namespace {
+/**
+ * @brief Returns the (estimated) number of bytes used to intern a name: its copies
+ *        in the table & its index, & their bookkeeping.
+ */
+size_t nameFootprint(const std::string& name) {
+    return 2 * (sizeof(std::string) + name.size()) + 2 * sizeof(uint32_t) + 4 * sizeof(void*);
+}
+};
+
+namespace Online {
+/**
+ * @brief Constructs an empty ranker.
+ *
+ * @param capacity The number of Players to keep (ie. the k in top-k)
+ * @param checkpoint_interval The number of events between checkpoints
+ * @param memory_budget The number of bytes checkpoints, deltas & names may use (0 for no limit)
+ */
+VersionedRanker::VersionedRanker(const size_t& capacity, const size_t& checkpoint_interval, const size_t& memory_budget)
+    : capacity_ { capacity }
+    , checkpointInterval_ { checkpoint_interval == 0 ? 1 : checkpoint_interval }
+    , memoryBudget_ { memory_budget }
+    , checkpointBytes_ { 0 }
+    , deltaBytes_ { 0 }
+    , nameBytes_ { 0 }
+    , events_ { 0 }
+    , deltaBase_ { 0 }
+{
+    //The empty heap before any events is always a valid starting point
+    checkpoint();
+}
+
+/**
+ * @brief Applies an accepted Player to a heap, exactly as `offer()` did.
+ */
+void VersionedRanker::apply(std::vector<Player>& heap, Player player) const {
+    if (heap.size() < capacity_) {
+        heap.push_back(player);
+        if (heap.size() == capacity_) {
+            std::make_heap(heap.begin(), heap.end(), std::greater<Player>());
+        }
+    } else {
+        replaceMin(heap.begin(), heap.end(), player);
+    }
+}
+
+/**
+ * @brief Returns a compact entry for a Player, interning (& referencing) its name.
+ */
+VersionedRanker::Entry VersionedRanker::intern(const Player& player) {
+    auto it = nameIndex_.find(player.name_);
+    uint32_t index;
+    if (it != nameIndex_.end()) {
+        index = it->second;
+    } else {
+        if (!freeNames_.empty()) {
+            index = freeNames_.back();
+            freeNames_.pop_back();
+            names_[index] = player.name_;
+        } else {
+            index = static_cast<uint32_t>(names_.size());
+            names_.push_back(player.name_);
+            references_.push_back(0);
+        }
+        nameIndex_.emplace(player.name_, index);
+        nameBytes_ += nameFootprint(player.name_);
+    }
+
+    references_[index]++;
+    return Entry { player.level_, player.id_, index };
+}
+
+/**
+ * @brief Drops an entry's reference to its name, freeing the name if it was the last.
+ */
+void VersionedRanker::release(const Entry& entry) {
+    if (--references_[entry.name_] == 0) {
+        std::string& name = names_[entry.name_];
+        nameBytes_ -= nameFootprint(name);
+        nameIndex_.erase(name);
+        std::string().swap(name);
+        freeNames_.push_back(entry.name_);
+    }
+}
+
+/**
+ * @brief Returns the Player recorded by an entry.
+ */
+Player VersionedRanker::playerOf(const Entry& entry) const {
+    return Player(names_[entry.name_], entry.level_, entry.id_);
+}
+
+/**
+ * @brief Records a checkpoint of the live heap after the current event.
+ */
+void VersionedRanker::checkpoint() {
+    Checkpoint taken { events_, deltaBase_ + deltas_.size(), {} };
+    taken.heap_.reserve(heap_.size());
+    for (const Player& kept : heap_) {
+        taken.heap_.push_back(intern(kept));
+    }
+    checkpointBytes_ += sizeof(Checkpoint) + taken.heap_.size() * sizeof(Entry);
+    checkpoints_.push_back(std::move(taken));
+}
+
+/**
+ * @brief Discards the oldest checkpoint, & the deltas before the next one.
+ */
+void VersionedRanker::dropOldest() {
+    Checkpoint& oldest = checkpoints_.front();
+    for (const Entry& entry : oldest.heap_) {
+        release(entry);
+    }
+    checkpointBytes_ -= sizeof(Checkpoint) + oldest.heap_.size() * sizeof(Entry);
+
+    size_t keptFrom = checkpoints_.size() > 1 ? checkpoints_[1].deltas_ : deltaBase_ + deltas_.size();
+    while (deltaBase_ < keptFrom) {
+        release(deltas_.front().entry_);
+        deltas_.pop_front();
+        deltaBytes_ -= sizeof(Delta);
+        deltaBase_++;
+    }
+    checkpoints_.erase(checkpoints_.begin());
+}
+
+/**
+ * @brief Brings the memory used within the budget (see the constructor).
+ *
+ * @throws std::length_error If even a single checkpoint of the current heap exceeds it.
+ */
+void VersionedRanker::enforceBudget() {
+    while (memoryBudget_ != 0 && bytes() > memoryBudget_) {
+        if (checkpoints_.size() > 1 && checkpointBytes_ > deltaBytes_) {
+            checkpointInterval_ *= 2;
+
+            //Keep the oldest checkpoint (the start of the history) & those on the new interval
+            std::vector<Checkpoint> kept;
+            for (size_t i = 0; i < checkpoints_.size(); ++i) {
+                Checkpoint& checkpoint = checkpoints_[i];
+                if (i == 0 || checkpoint.event_ % checkpointInterval_ == 0) {
+                    kept.push_back(std::move(checkpoint));
+                } else {
+                    for (const Entry& entry : checkpoint.heap_) {
+                        release(entry);
+                    }
+                    checkpointBytes_ -= sizeof(Checkpoint) + checkpoint.heap_.size() * sizeof(Entry);
+                }
+            }
+            checkpoints_ = std::move(kept);
+        } else if (checkpoints_.size() > 1) {
+            dropOldest();
+        } else if (checkpoints_.front().event_ < events_) {
+            //Restart the history from the current heap
+            dropOldest();
+            checkpoint();
+        } else {
+            throw std::length_error("Memory budget of " + std::to_string(memoryBudget_) + " bytes cannot hold a checkpoint of "
+                + std::to_string(heap_.size()) + " Players");
+        }
+    }
+}
+
+/**
+ * @brief Processes the next Player of a stream (ie. event number events() + 1).
+ *
+ * @param player The Player to be offered
+ * @throws std::length_error If the memory budget cannot hold a single checkpoint.
+ */
+void VersionedRanker::offer(const Player& player) {
+    events_++;
+
+    //Record a delta for exactly those Players rankIncoming() would accept
+    if (capacity_ > 0 && (heap_.size() < capacity_ || player > heap_.front())) {
+        deltas_.push_back(Delta { events_, intern(player) });
+        deltaBytes_ += sizeof(Delta);
+        apply(heap_, player);
+    }
+
+    if (events_ % checkpointInterval_ == 0) {
+        checkpoint();
+    }
+
+    enforceBudget();
+}
+
+/**
+ * @brief Exhausts a stream of Players, offering each in turn.
+ *
+ * @param stream A stream providing Player objects
+ * @throws std::length_error If the memory budget cannot hold a single checkpoint.
+ * @post All elements of the stream are read until there are none remaining
+ *       (unless an exception is thrown).
+ */
+void VersionedRanker::ingest(PlayerStream& stream) {
+    while (stream.remaining() > 0) {
+        offer(stream.nextPlayer());
+    }
+}
+
+/**
+ * @brief Reconstructs the leaderboard as it was after a given event.
+ *
+ * @param event The number of events after which to query, in [earliest(), events()]
+ * @return A RankingResult in which:
+ * - top_       -> Contains the top Players after `event` events, in sorted (least to greatest) order
+ * - cutoffs_   -> Maps `event` to the minimum level required at that point (empty if top_ is)
+ * - elapsed_   -> Contains the duration (ms) of the reconstruction
+ *
+ * @throws std::out_of_range If `event` is greater than events(), or its history has
+ *         been discarded to meet the memory budget (ie. it is less than earliest())
+ */
+RankingResult VersionedRanker::rankAt(const size_t& event) const {
+    if (event > events_) {
+        throw std::out_of_range("Event has not been processed yet");
+    }
+    if (event < earliest()) {
+        throw std::out_of_range("Event " + std::to_string(event) + " precedes the retained history (from event "
+            + std::to_string(earliest()) + ")");
+    }
+
+    //Start timer for elapsed_
+    auto start = std::chrono::high_resolution_clock::now();
+
+    //Find the last checkpoint at or before the event
+    auto after = std::upper_bound(checkpoints_.begin(), checkpoints_.end(), event,
+        [](const size_t& e, const Checkpoint& checkpoint) { return e < checkpoint.event_; });
+    const Checkpoint& checkpoint = *(after - 1);
+
+    //Rebuild its heap (in the same order), then replay the Players accepted since then
+    std::vector<Player> heap;
+    heap.reserve(capacity_);
+    for (const Entry& entry : checkpoint.heap_) {
+        heap.push_back(playerOf(entry));
+    }
+    for (size_t i = checkpoint.deltas_ - deltaBase_; i < deltas_.size() && deltas_[i].event_ <= event; ++i) {
+        apply(heap, playerOf(deltas_[i].entry_));
+    }
+
+    std::unordered_map<size_t, size_t> cutoffs;
+    std::sort(heap.begin(), heap.end());
+    if (!heap.empty()) {
+        cutoffs[event] = heap.front().level_;
+    }
+
+    //Stop timer and calculate elapsed_
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(end - start).count();
+
+    return RankingResult(heap, cutoffs, elapsed);
+}
+
+/**
+ * @brief Returns the number of Players offered so far.
+ */
+size_t VersionedRanker::events() const {
+    return events_;
+}
+
+/**
+ * @brief Returns the earliest event which can still be queried (0 unless
+ *        history has been discarded to meet the memory budget).
+ */
+size_t VersionedRanker::earliest() const {
+    return checkpoints_.front().event_;
+}
+
+/**
+ * @brief Returns the current number of events between checkpoints.
+ */
+size_t VersionedRanker::checkpointInterval() const {
+    return checkpointInterval_;
+}
+
+/**
+ * @brief Returns the (estimated) number of bytes used by checkpoints, deltas & names.
+ */
+size_t VersionedRanker::bytes() const {
+    return checkpointBytes_ + deltaBytes_ + nameBytes_;
+}
+};
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "Leaderboard.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Online {
+/**
+ * @brief A persistent (time-travel) version of `rankIncoming()`, which can
+ *        reconstruct the exact top-k after any event index n.
+ *
+ * Ingestion runs exactly as `rankIncoming()` does (the STL heap operations &
+ * `replaceMin()`), while recording:
+ * 1) A checkpoint: a copy of the raw heap every <checkpoint_interval> events.
+ * 2) A delta: each Player that was accepted into the heap, & the event at which it was.
+ *
+ * Both store compact entries (level, id & the index of the Player's name in a table
+ * of interned names) rather than whole Players, so a name is stored once however
+ * often its Player is accepted or checkpointed.
+ *
+ * As the heap operations are deterministic, replaying the deltas after a checkpoint
+ * onto a copy of its heap rebuilds the heap exactly as it was (ties included), in
+ * O(k + d log k) time for the d deltas since that checkpoint.
+ *
+ * Rejected Players (ie. the vast majority, once the heap is full) cost nothing to store.
+ *
+ * @example Suppose we have a capacity of 50 & a checkpoint interval of 1000.
+ * Then rankAt(2345) copies the checkpoint at event 2000, replays the accepted Players
+ * among events 2001...2345, & sorts the result.
+ */
+class VersionedRanker {
+private:
+    /**
+     * @brief A compact record of a Player: its level, id & interned name.
+     */
+    struct Entry {
+        uint64_t level_;
+        uint64_t id_;
+        uint32_t name_; //The index of the Player's name in names_
+    };
+
+    /**
+     * @brief A Player accepted into the heap, & the event at which it was.
+     */
+    struct Delta {
+        uint64_t event_;
+        Entry entry_;
+    };
+
+    /**
+     * @brief A copy of the heap after `event_` events, together with the number
+     *        of deltas recorded by then (counting those since discarded).
+     */
+    struct Checkpoint {
+        size_t event_;
+        size_t deltas_;
+        std::vector<Entry> heap_;
+    };
+
+    size_t capacity_; //The number of Players kept (ie. the k in top-k)
+    size_t checkpointInterval_; //The number of events between checkpoints
+    size_t memoryBudget_; //The number of bytes checkpoints, deltas & names may use, or 0 if unbounded
+    size_t checkpointBytes_; //The number of bytes used by checkpoints
+    size_t deltaBytes_; //The number of bytes used by deltas
+    size_t nameBytes_; //The (estimated) number of bytes used by interned names
+    size_t events_; //The number of Players offered so far
+
+    std::vector<Player> heap_; //The live heap, as in rankIncoming()
+    std::vector<Checkpoint> checkpoints_; //Checkpoints, in increasing event order
+    std::deque<Delta> deltas_; //The deltas retained, in acceptance order
+    size_t deltaBase_; //The number of deltas discarded from the front of deltas_
+
+    std::vector<std::string> names_; //Interned names, by index
+    std::vector<uint32_t> references_; //The number of entries referring to each name
+    std::vector<uint32_t> freeNames_; //The indices of names_ no longer referred to
+    std::unordered_map<std::string, uint32_t> nameIndex_; //The index of each interned name
+
+    /**
+     * @brief Applies an accepted Player to a heap, exactly as `offer()` did.
+     */
+    void apply(std::vector<Player>& heap, Player player) const;
+
+    /**
+     * @brief Returns a compact entry for a Player, interning (& referencing) its name.
+     */
+    Entry intern(const Player& player);
+
+    /**
+     * @brief Drops an entry's reference to its name, freeing the name if it was the last.
+     */
+    void release(const Entry& entry);
+
+    /**
+     * @brief Returns the Player recorded by an entry.
+     */
+    Player playerOf(const Entry& entry) const;
+
+    /**
+     * @brief Records a checkpoint of the live heap after the current event.
+     */
+    void checkpoint();
+
+    /**
+     * @brief Discards the oldest checkpoint, & the deltas before the next one.
+     */
+    void dropOldest();
+
+    /**
+     * @brief Brings the memory used within the budget (see the constructor).
+     *
+     * @throws std::length_error If even a single checkpoint of the current heap exceeds it.
+     */
+    void enforceBudget();
+
+public:
+    /**
+     * @brief Constructs an empty ranker.
+     *
+     * @param capacity The number of Players to keep (ie. the k in top-k)
+     * @param checkpoint_interval The number of events between checkpoints. Smaller values
+     *        answer queries faster, at the cost of a copy of the heap per checkpoint.
+     * @param memory_budget The number of bytes checkpoints, deltas & names may use (0 for no limit).
+     *        When exceeded:
+     *        1) While checkpoints use more than the deltas, every other checkpoint is dropped
+     *           & the interval doubles. As there are then fewer deltas than heap entries
+     *           between checkpoints, queries still replay O(k) deltas.
+     *        2) Otherwise, the oldest history is discarded: the oldest checkpoint & the deltas
+     *           before the next are dropped, so `earliest()` rises. Should one checkpoint
+     *           remain, it is replaced by one of the current heap.
+     *        So queries never degrade to replaying the whole stream; rather, events before
+     *        `earliest()` can no longer be queried.
+     */
+    VersionedRanker(const size_t& capacity, const size_t& checkpoint_interval, const size_t& memory_budget = 0);
+
+    /**
+     * @brief Processes the next Player of a stream (ie. event number events() + 1).
+     *
+     * Performs in O(log k) time, plus an O(k) copy every <checkpoint_interval> events.
+     *
+     * @param player The Player to be offered
+     * @throws std::length_error If the memory budget cannot hold a single checkpoint.
+     */
+    void offer(const Player& player);
+
+    /**
+     * @brief Exhausts a stream of Players, offering each in turn.
+     *
+     * @param stream A stream providing Player objects
+     * @throws std::length_error If the memory budget cannot hold a single checkpoint.
+     * @post All elements of the stream are read until there are none remaining
+     *       (unless an exception is thrown).
+     */
+    void ingest(PlayerStream& stream);
+
+    /**
+     * @brief Reconstructs the leaderboard as it was after a given event.
+     *
+     * Performs in O(k log k + d log k) time, where d is the number of Players
+     * accepted since the nearest preceding checkpoint.
+     *
+     * @param event The number of events after which to query, in [earliest(), events()]
+     * @return A RankingResult in which:
+     * - top_       -> Contains the top Players after `event` events, in sorted (least to greatest) order
+     * - cutoffs_   -> Maps `event` to the minimum level required at that point (empty if top_ is)
+     * - elapsed_   -> Contains the duration (ms) of the reconstruction
+     *
+     * @throws std::out_of_range If `event` is greater than events(), or its history has
+     *         been discarded to meet the memory budget (ie. it is less than earliest())
+     */
+    RankingResult rankAt(const size_t& event) const;
+
+    /**
+     * @brief Returns the number of Players offered so far.
+     */
+    size_t events() const;
+
+    /**
+     * @brief Returns the earliest event which can still be queried (0 unless
+     *        history has been discarded to meet the memory budget).
+     */
+    size_t earliest() const;
+
+    /**
+     * @brief Returns the current number of events between checkpoints.
+     */
+    size_t checkpointInterval() const;
+
+    /**
+     * @brief Returns the (estimated) number of bytes used by checkpoints, deltas & names.
+     */
+    size_t bytes() const;
+};
+};